@@ -33,5 +33,8 @@ public class DaxSystem : ModuleRules {
                 "NetCore",
             }
         );
+
+        // 启用 Iris 时依赖 IrisCore, 否则依赖 IrisStub; DaxComponent.h 公开引用了 Iris 的序列化器类型, 作为公开依赖添加
+        SetupIrisSupport(Target, true);
     }
 }
\ No newline at end of file
@@ -57,6 +57,7 @@ AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FDaxSet(
         FDaxSet_.Method("FString GetString() const", &FDaxSet::GetString);
         FDaxSet_.Method("FString GetStringDebug() const", &FDaxSet::GetStringDebug);
         // 下线：FDaxSet 的监听相关 API 由 Subsystem 统一管理，不再在 AS 暴露
+        // 脚本监听目前经 UDaxComponent::BindOnChanged 走 ProcessEvent; 直接调用脚本函数的绑定尚未提供, 作为后续工作单独跟进
     }
 });
 
@@ -94,6 +95,8 @@ AS_FORCE_LINK const FAngelscriptBinds::FBind Bind_FDaxVisitor(
         DAX_BUILTIN_TYPE_BIND_AS(FString, const FString& Value, String);
         DAX_BUILTIN_TYPE_BIND_AS(FVector, const FVector& Value, Vector);
         DAX_BUILTIN_TYPE_BIND_AS(FRotator, const FRotator& Value, Rotator);
+        DAX_BUILTIN_TYPE_BIND_AS(FVector, const FVector& Value, VectorQ);
+        DAX_BUILTIN_TYPE_BIND_AS(FRotator, const FRotator& Value, RotatorQ);
         
         FDaxVisitor_.Method("FDaxStructView<FScriptStructWildcard> TryGetValue(const UScriptStruct ValueType) const",
                             [](const FDaxVisitor& Visitor, const UScriptStruct* TargetStruct) {
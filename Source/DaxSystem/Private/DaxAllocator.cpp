@@ -28,6 +28,7 @@ FDaxNodeID FDaxAllocator::Allocate() {
     Stats.TotalAllocated++;
     Stats.CurrentActive++;
     Stats.PeakActive = FMath::Max(Stats.PeakActive, static_cast<uint32>(Stats.CurrentActive));
+    MarkChunkDirty(ChunkIndex);
 
     uint16 Generation = Chunk->Meta.Generations[LocalIndex];
     return FDaxNodeID(GlobalIndex, Generation);
@@ -51,9 +52,11 @@ FDaxAllocateResult FDaxAllocator::AllocateSlotAt(const FDaxNodeID SpecificNodeID
             Stats.TotalAllocated++;
             Stats.CurrentActive++;
             Stats.PeakActive = FMath::Max(Stats.PeakActive, static_cast<uint32>(Stats.CurrentActive));
+            MarkChunkDirty(ChunkIndex);
             return FDaxAllocateResult::NewOne;
         case FDaxAllocateResult::Replaced:
             Stats.TotalAllocated++;
+            MarkChunkDirty(ChunkIndex);
             return FDaxAllocateResult::Replaced;
         case FDaxAllocateResult::Exist:
             return FDaxAllocateResult::Exist;
@@ -75,6 +78,7 @@ bool FDaxAllocator::Deallocate(const FDaxNodeID ID) {
     if (Chunks[ChunkIndex]->DeallocateSlot(LocalIndex, ID.Generation)) {
         Stats.TotalDeallocated++;
         Stats.CurrentActive--;
+        MarkChunkDirty(ChunkIndex);
         return true;
     }
             
@@ -87,9 +91,38 @@ uint16 FDaxAllocator::AllocateNewChunk() {
         return 0xFFFF;
     }
     Chunks.Emplace(MakeUnique<FDaxNodeChunk>(NewIndex));
+    MarkChunkDirty(NewIndex);
     return NewIndex;
 }
 
+uint32 FDaxAllocator::FlushDirtyChunks() {
+    bool bAnyDirty = false;
+    for (const uint32 Word : DirtyChunkBits) {
+        if (Word != 0) { bAnyDirty = true; break; }
+    }
+    if (!bAnyDirty) return ChangeEpoch;
+
+    ++ChangeEpoch;
+    if (ChunkEpochs.Num() < Chunks.Num()) ChunkEpochs.SetNumZeroed(Chunks.Num());
+    const int32 GroupCount = (ChunkEpochs.Num() + 31) >> 5;
+    if (ChunkGroupEpochs.Num() < GroupCount) ChunkGroupEpochs.SetNumZeroed(GroupCount);
+
+    for (int32 Word = 0; Word < DirtyChunkBits.Num(); ++Word) {
+        uint32 Bits = DirtyChunkBits[Word];
+        if (Bits == 0) continue;
+        while (Bits) {
+            const int32 ChunkIndex = (Word << 5) + FMath::CountTrailingZeros(Bits);
+            Bits &= Bits - 1;
+            if (!ChunkEpochs.IsValidIndex(ChunkIndex)) continue; // 块已被 Reset 掉
+            ChunkEpochs[ChunkIndex] = ChangeEpoch;
+        }
+        // 每个位图字正好对应一个 32 块分组
+        if (ChunkGroupEpochs.IsValidIndex(Word)) ChunkGroupEpochs[Word] = ChangeEpoch;
+        DirtyChunkBits[Word] = 0;
+    }
+    return ChangeEpoch;
+}
+
 uint16 FDaxAllocator::SelectOrCreateChunkForBestAllocation() { //直接找第一个有空位的块, 这里不做freelist, 对于低数量级的线性的遍历并不慢, 做了候选下标已经足够
     if (Chunks.IsValidIndex(Stats.FirstNotFullHintChunk)) {
         if (Chunks[Stats.FirstNotFullHintChunk]->HasFreeSlot()) {
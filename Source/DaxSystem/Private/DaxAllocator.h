@@ -27,6 +27,10 @@ namespace ArzDax {
             Chunks = MoveTemp(Other.Chunks);
             Stats = Other.Stats;
             Other.Stats = {};
+            ChangeEpoch = Other.ChangeEpoch;
+            ChunkEpochs = MoveTemp(Other.ChunkEpochs);
+            ChunkGroupEpochs = MoveTemp(Other.ChunkGroupEpochs);
+            DirtyChunkBits = MoveTemp(Other.DirtyChunkBits);
         }
 
         FDaxAllocator& operator=(FDaxAllocator&& Other) {
@@ -34,6 +38,10 @@ namespace ArzDax {
             Chunks = MoveTemp(Other.Chunks);
             Stats = Other.Stats;
             Other.Stats = {};
+            ChangeEpoch = Other.ChangeEpoch;
+            ChunkEpochs = MoveTemp(Other.ChunkEpochs);
+            ChunkGroupEpochs = MoveTemp(Other.ChunkGroupEpochs);
+            DirtyChunkBits = MoveTemp(Other.DirtyChunkBits);
             return *this;
         }
 
@@ -49,6 +57,10 @@ namespace ArzDax {
         FORCEINLINE void Reset() {
             Chunks.Empty();
             Stats = {};
+            // ChangeEpoch 不回退, 保证旧连接的 Epoch 与重建后的块比较时依然成立
+            ChunkEpochs.Empty();
+            ChunkGroupEpochs.Empty();
+            DirtyChunkBits.Empty();
         }
 
         FORCEINLINE const FDaxNodeChunkMeta* GetChunkMetadata(const uint16 ChunkIndex) const {
@@ -80,6 +92,7 @@ namespace ArzDax {
             if (!Chunks.IsValidIndex(ChunkIndex)) return {};
             const uint16 LocalIndex = ToLocal(ID.Index);
             if (!Chunks[ChunkIndex]->IsNodeValid(LocalIndex, ID.Generation)) return {};
+            MarkChunkDirty(ChunkIndex); // 交出可写引用视为一次修改
             return Chunks[ChunkIndex]->UnsafeGetValueTypeRef(LocalIndex);
         }
 
@@ -115,6 +128,7 @@ namespace ArzDax {
             if (!Chunks.IsValidIndex(ChunkIndex)) return {};
             const uint16 LocalIndex = ToLocal(ID.Index);
             if (!Chunks[ChunkIndex]->IsNodeValid(LocalIndex, ID.Generation)) return {};
+            MarkChunkDirty(ChunkIndex); // 交出可写引用视为一次修改
             return Chunks[ChunkIndex]->UnsafeGetCommonInfoRef(LocalIndex);
         }
 
@@ -146,6 +160,7 @@ namespace ArzDax {
             if (!Chunks.IsValidIndex(ChunkIndex)) return {};
             const uint16 LocalIndex = ToLocal(ID.Index);
             if (!Chunks[ChunkIndex]->IsNodeValid(LocalIndex, ID.Generation)) return {};
+            MarkChunkDirty(ChunkIndex); // 交出可写引用视为一次修改
             return Chunks[ChunkIndex]->UnsafeGetParentRef(LocalIndex);
         }
 
@@ -214,6 +229,7 @@ namespace ArzDax {
             const uint16 LocalIndex = ToLocal(ID.Index);
             if (!Chunks[ChunkIndex]->IsNodeValid(LocalIndex, ID.Generation)) return false;
             Chunks[ChunkIndex]->UnsafeMarkDirtyAndBump(LocalIndex, bBumpVersion);
+            MarkChunkDirty(ChunkIndex);
             return true;
         }
 
@@ -225,9 +241,40 @@ namespace ArzDax {
             const uint16 LocalIndex = ToLocal(ID.Index);
             if (!Chunks[ChunkIndex]->IsNodeValid(LocalIndex, ID.Generation)) return false;
             Chunks[ChunkIndex]->UnsafeUpdateValueType(LocalIndex, NewType);
+            MarkChunkDirty(ChunkIndex);
             return true;
         }
 
+        // ===================== 脏块追踪（网络增量同步） =====================
+        // 修改只置位, 由发送端在每次序列化前 Flush 成单调递增的块 Epoch,
+        // 连接只需要记住自己上次确认的 Epoch, 就能跳过所有未变化的块.
+        FORCEINLINE void MarkChunkDirty(const uint16 ChunkIndex) const {
+            const int32 Word = ChunkIndex >> 5;
+            if (DirtyChunkBits.Num() <= Word) DirtyChunkBits.SetNumZeroed(Word + 1);
+            DirtyChunkBits[Word] |= (1u << (ChunkIndex & 31));
+        }
+
+        uint32 FlushDirtyChunks(); // 把脏位图折叠成新的 Epoch 并清空, 返回当前 Epoch
+
+        FORCEINLINE uint32 GetChangeEpoch() const { return ChangeEpoch; }
+
+        FORCEINLINE uint32 GetChunkEpoch(const uint16 ChunkIndex) const {
+            return ChunkEpochs.IsValidIndex(ChunkIndex) ? ChunkEpochs[ChunkIndex] : 0;
+        }
+
+        // 遍历 Epoch 比 SinceEpoch 新的块（先按 32 块一组跳过, 再逐块比较）
+        template <typename Func>
+        void ForEachChunkChangedSince(const uint32 SinceEpoch, Func&& Function) const {
+            for (int32 Group = 0; Group < ChunkGroupEpochs.Num(); ++Group) {
+                if (ChunkGroupEpochs[Group] <= SinceEpoch) continue;
+                const int32 Begin = Group << 5;
+                const int32 End = FMath::Min(Begin + 32, ChunkEpochs.Num());
+                for (int32 ci = Begin; ci < End; ++ci) {
+                    if (ChunkEpochs[ci] > SinceEpoch) Function(static_cast<uint16>(ci));
+                }
+            }
+        }
+
         FORCEINLINE uint32 GetTotalAllocated() const { return Stats.TotalAllocated; } //总共分配过多少次
         FORCEINLINE uint32 GetTotalDeallocated() const { return Stats.TotalDeallocated; } //总共删除过多少次
         FORCEINLINE uint32 GetCurrentActive() const { return Stats.CurrentActive; } // 当前数量
@@ -256,6 +303,14 @@ namespace ArzDax {
         }
 
     private:
+        uint32 ChangeEpoch = 0; // 单调递增, 每次 Flush 出现脏块时 +1
+
+        TArray<uint32, TInlineAllocator<4>> ChunkEpochs{}; // 每个块最后一次变更的 Epoch
+
+        TArray<uint32, TInlineAllocator<1>> ChunkGroupEpochs{}; // 每 32 个块中最大的 Epoch
+
+        mutable TArray<uint32, TInlineAllocator<1>> DirtyChunkBits{}; // 自上次 Flush 以来被修改过的块
+
         uint16 AllocateNewChunk();
 
         uint16 SelectOrCreateChunkForBestAllocation();
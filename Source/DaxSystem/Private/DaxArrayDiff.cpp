@@ -0,0 +1,228 @@
+﻿#include "DaxSystem/Private/DaxArrayDiff.h"
+
+using namespace ArzDax;
+
+namespace {
+    // 单个数组最多 65535 个元素, 超出视为损坏的数据
+    constexpr uint32 MaxArrayEdits = 0xFFFF;
+
+    FORCEINLINE uint32 PackedBytes(const uint32 Value) {
+        if (Value < (1u << 7)) return 1;
+        if (Value < (1u << 14)) return 2;
+        if (Value < (1u << 21)) return 3;
+        return 4;
+    }
+
+    FORCEINLINE uint32 IDBytes(const FDaxNodeID ID) {
+        return PackedBytes(ID.Index) + PackedBytes(ID.Generation);
+    }
+
+    uint32 HashArray(TConstArrayView<FDaxNodeID> Array) {
+        uint32 Hash = static_cast<uint32>(Array.Num());
+        for (const FDaxNodeID ID : Array) Hash = HashCombineFast(Hash, GetTypeHash(ID));
+        return Hash;
+    }
+
+    // 对 Sequence 求最长严格递增子序列, 返回其在 Sequence 中的位置(升序)
+    void LongestIncreasing(TConstArrayView<int32> Sequence, TArray<int32>& OutPositions) {
+        OutPositions.Reset();
+        const int32 Num = Sequence.Num();
+        if (Num == 0) return;
+        TArray<int32> Tails;       // Tails[k]: 长度为 k+1 的递增子序列中, 末尾值最小的那个的位置
+        TArray<int32> Predecessor; // 每个位置在子序列中的前驱
+        Tails.Reserve(Num);
+        Predecessor.SetNumUninitialized(Num);
+        for (int32 i = 0; i < Num; ++i) {
+            const int32 Value = Sequence[i];
+            int32 Low = 0;
+            int32 High = Tails.Num();
+            while (Low < High) {
+                const int32 Mid = (Low + High) >> 1;
+                if (Sequence[Tails[Mid]] < Value) Low = Mid + 1;
+                else High = Mid;
+            }
+            Predecessor[i] = Low > 0 ? Tails[Low - 1] : INDEX_NONE;
+            if (Low == Tails.Num()) Tails.Add(i);
+            else Tails[Low] = i;
+        }
+        OutPositions.SetNumUninitialized(Tails.Num());
+        int32 Cursor = Tails.Last();
+        for (int32 k = Tails.Num() - 1; k >= 0; --k) {
+            OutPositions[k] = Cursor;
+            Cursor = Predecessor[Cursor];
+        }
+    }
+}
+
+void FDaxArrayDiff::Build(TConstArrayView<FDaxNodeID> Old, TConstArrayView<FDaxNodeID> New, FDaxArrayEditScript& OutScript) {
+    OutScript.Reset();
+    OutScript.BaseHash = HashArray(Old);
+    const int32 OldN = Old.Num();
+    const int32 NewN = New.Num();
+
+    // 公共前缀/后缀直接保留, 只对中间段做匹配
+    int32 L = 0;
+    while (L < OldN && L < NewN && Old[L] == New[L]) ++L;
+    int32 R = 0;
+    while (OldN - R - 1 >= L && NewN - R - 1 >= L && Old[OldN - R - 1] == New[NewN - R - 1]) ++R;
+    const int32 OldEnd = OldN - R;
+    const int32 NewEnd = NewN - R;
+    if (L == OldEnd && L == NewEnd) return;
+
+    // 中间段: 按 ID 匹配新旧位置. 无效 ID 和重复 ID 不参与匹配, 一律按删除 + 插入处理
+    TMap<FDaxNodeID, int32> OldPositions;
+    OldPositions.Reserve(OldEnd - L);
+    for (int32 i = L; i < OldEnd; ++i) {
+        if (Old[i].IsValid()) OldPositions.FindOrAdd(Old[i], i);
+    }
+    TArray<int32> MatchedNew;
+    TArray<int32> MatchedOld;
+    for (int32 j = L; j < NewEnd; ++j) {
+        if (!New[j].IsValid()) continue;
+        if (int32* Found = OldPositions.Find(New[j])) {
+            if (*Found == INDEX_NONE) continue;
+            MatchedNew.Add(j);
+            MatchedOld.Add(*Found);
+            *Found = INDEX_NONE;
+        }
+    }
+
+    TArray<int32> KeptPositions;
+    LongestIncreasing(MatchedOld, KeptPositions);
+    TBitArray<> OldKept(false, OldEnd - L);
+    TBitArray<> NewKept(false, NewEnd - L);
+    for (const int32 Position : KeptPositions) {
+        OldKept[MatchedOld[Position] - L] = true;
+        NewKept[MatchedNew[Position] - L] = true;
+    }
+
+    for (int32 i = L; i < OldEnd; ++i) {
+        if (!OldKept[i - L]) OutScript.RemoveIndices.Add(i);
+    }
+    for (int32 j = L; j < NewEnd; ++j) {
+        if (!NewKept[j - L]) OutScript.Inserts.Emplace(j, New[j]);
+    }
+}
+
+uint32 FDaxArrayDiff::EstimateScriptBytes(const FDaxArrayEditScript& Script) {
+    uint32 Bytes = sizeof(Script.BaseHash) + PackedBytes(Script.RemoveIndices.Num()) + PackedBytes(Script.Inserts.Num());
+    int32 Previous = -1;
+    for (const int32 Index : Script.RemoveIndices) {
+        Bytes += PackedBytes(static_cast<uint32>(Index - Previous - 1));
+        Previous = Index;
+    }
+    Previous = -1;
+    for (const auto& Insert : Script.Inserts) {
+        Bytes += PackedBytes(static_cast<uint32>(Insert.Key - Previous - 1)) + IDBytes(Insert.Value);
+        Previous = Insert.Key;
+    }
+    return Bytes;
+}
+
+uint32 FDaxArrayDiff::EstimateFullBytes(TConstArrayView<FDaxNodeID> New) {
+    uint32 Bytes = PackedBytes(New.Num());
+    for (const FDaxNodeID ID : New) Bytes += IDBytes(ID);
+    return Bytes;
+}
+
+void FDaxArrayDiff::Write(FArchive& Ar, const FDaxArrayEditScript& Script) {
+    uint32 BaseHash = Script.BaseHash;
+    Ar << BaseHash;
+    uint32 RemoveCount = static_cast<uint32>(Script.RemoveIndices.Num());
+    Ar.SerializeIntPacked(RemoveCount);
+    int32 Previous = -1;
+    for (const int32 Index : Script.RemoveIndices) {
+        uint32 Gap = static_cast<uint32>(Index - Previous - 1);
+        Ar.SerializeIntPacked(Gap);
+        Previous = Index;
+    }
+    uint32 InsertCount = static_cast<uint32>(Script.Inserts.Num());
+    Ar.SerializeIntPacked(InsertCount);
+    Previous = -1;
+    for (const auto& Insert : Script.Inserts) {
+        uint32 Gap = static_cast<uint32>(Insert.Key - Previous - 1);
+        Ar.SerializeIntPacked(Gap);
+        FDaxNodeID ID = Insert.Value;
+        Ar << ID;
+        Previous = Insert.Key;
+    }
+}
+
+bool FDaxArrayDiff::Read(FArchive& Ar, FDaxArrayEditScript& OutScript) {
+    OutScript.Reset();
+    Ar << OutScript.BaseHash;
+    uint32 RemoveCount = 0;
+    Ar.SerializeIntPacked(RemoveCount);
+    if (RemoveCount > MaxArrayEdits) {
+        Ar.SetError();
+        return false;
+    }
+    OutScript.RemoveIndices.Reserve(RemoveCount);
+    int64 Previous = -1;
+    for (uint32 k = 0; k < RemoveCount; ++k) {
+        uint32 Gap = 0;
+        Ar.SerializeIntPacked(Gap);
+        Previous += static_cast<int64>(Gap) + 1;
+        OutScript.RemoveIndices.Add(static_cast<int32>(FMath::Min<int64>(Previous, MAX_int32)));
+    }
+    uint32 InsertCount = 0;
+    Ar.SerializeIntPacked(InsertCount);
+    if (InsertCount > MaxArrayEdits) {
+        Ar.SetError();
+        return false;
+    }
+    OutScript.Inserts.Reserve(InsertCount);
+    Previous = -1;
+    for (uint32 k = 0; k < InsertCount; ++k) {
+        uint32 Gap = 0;
+        Ar.SerializeIntPacked(Gap);
+        FDaxNodeID ID;
+        Ar << ID;
+        Previous += static_cast<int64>(Gap) + 1;
+        OutScript.Inserts.Emplace(static_cast<int32>(FMath::Min<int64>(Previous, MAX_int32)), ID);
+    }
+    return !Ar.IsError();
+}
+
+bool FDaxArrayDiff::Apply(TArray<FDaxNodeID>& Array, const FDaxArrayEditScript& Script, TFunctionRef<void(FDaxNodeID, int32)> OnIndexChanged) {
+    if (Script.IsEmpty()) return true;
+    if (HashArray(Array) != Script.BaseHash) return false;
+    const int32 OldN = Array.Num();
+    if (!Script.RemoveIndices.IsEmpty() && Script.RemoveIndices.Last() >= OldN) return false;
+    const int32 NewN = OldN - Script.RemoveIndices.Num() + Script.Inserts.Num();
+    if (!Script.Inserts.IsEmpty() && Script.Inserts.Last().Key >= NewN) return false;
+
+    // 第一个被触达的位置之前的元素下标不变, 只重排其后的部分
+    int32 First = NewN;
+    if (!Script.RemoveIndices.IsEmpty()) First = FMath::Min(First, Script.RemoveIndices[0]);
+    if (!Script.Inserts.IsEmpty()) First = FMath::Min(First, Script.Inserts[0].Key);
+
+    // 先完整校验并生成新的尾部, 提交之后才回调, 失败时数组和父边都保持不变
+    TArray<FDaxNodeID> Tail;
+    Tail.Reserve(NewN - First);
+    TArray<int32> ChangedTargets;
+    int32 RemoveCursor = 0;
+    int32 InsertCursor = 0;
+    int32 OldCursor = First;
+    for (int32 Target = First; Target < NewN; ++Target) {
+        if (InsertCursor < Script.Inserts.Num() && Script.Inserts[InsertCursor].Key == Target) {
+            const FDaxNodeID ID = Script.Inserts[InsertCursor++].Value;
+            Tail.Add(ID);
+            ChangedTargets.Add(Target);
+            continue;
+        }
+        while (RemoveCursor < Script.RemoveIndices.Num() && Script.RemoveIndices[RemoveCursor] == OldCursor) {
+            ++RemoveCursor;
+            ++OldCursor;
+        }
+        if (OldCursor >= OldN) return false;
+        const FDaxNodeID ID = Array[OldCursor];
+        Tail.Add(ID);
+        if (OldCursor != Target) ChangedTargets.Add(Target);
+        ++OldCursor;
+    }
+    Array.SetNum(First, EAllowShrinking::No);
+    Array.Append(MoveTemp(Tail));
+    for (const int32 Target : ChangedTargets) OnIndexChanged(Array[Target], Target);
+    return true;
+}
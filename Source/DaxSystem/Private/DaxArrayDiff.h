@@ -0,0 +1,44 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "DaxSystem/Private/DaxNodeID.h"
+
+namespace ArzDax {
+
+    // 数组容器的编辑脚本: 先按旧下标删除, 再按新下标插入.
+    // 新旧两边都存在、且相对顺序不变(最长递增子序列)的元素原地保留, 其余元素的移动表示为 删除 + 插入.
+    // 脚本基于服务端最近一次发送的基线, 前一个包丢失时客户端的数组可能不是这个基线, 应用前按基线哈希校验
+    struct FDaxArrayEditScript {
+        uint32 BaseHash = 0; // 构建脚本时旧数组的哈希
+
+        TArray<int32> RemoveIndices {}; // 旧数组下标, 升序
+
+        TArray<TPair<int32, FDaxNodeID>> Inserts {}; // 新数组下标, 升序
+
+        FORCEINLINE bool IsEmpty() const { return RemoveIndices.IsEmpty() && Inserts.IsEmpty(); }
+
+        FORCEINLINE void Reset() {
+            BaseHash = 0;
+            RemoveIndices.Reset();
+            Inserts.Reset();
+        }
+    };
+
+    struct FDaxArrayDiff {
+        static void Build(TConstArrayView<FDaxNodeID> Old, TConstArrayView<FDaxNodeID> New, FDaxArrayEditScript& OutScript);
+
+        // 估算字节数, 写入方用来在 编辑脚本 / 整表发送 之间选择
+        static uint32 EstimateScriptBytes(const FDaxArrayEditScript& Script);
+
+        static uint32 EstimateFullBytes(TConstArrayView<FDaxNodeID> New);
+
+        // 线上格式: 基线哈希, 删除数 + 删除下标(间隔编码), 插入数 + (插入下标(间隔编码) + ID)
+        static void Write(FArchive& Ar, const FDaxArrayEditScript& Script);
+
+        static bool Read(FArchive& Ar, FDaxArrayEditScript& OutScript);
+
+        // 就地应用, 只对下标发生变化的元素回调 OnIndexChanged, 便于增量维护父边.
+        // 当前数组不是脚本的基线(哈希不同或下标越界)时返回 false, 数组保持不变且不回调
+        static bool Apply(TArray<FDaxNodeID>& Array, const FDaxArrayEditScript& Script, TFunctionRef<void(FDaxNodeID, int32)> OnIndexChanged);
+    };
+}
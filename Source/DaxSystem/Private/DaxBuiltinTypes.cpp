@@ -0,0 +1,55 @@
+﻿#include "DaxSystem/Public/DaxBuiltinTypes.h"
+#include "Engine/NetSerialization.h"
+
+bool FDaxBuiltinFloat::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+    uint8 bIntegral = 0;
+    int32 IntegralValue = 0;
+    if (Ar.IsSaving()) {
+        // -0.0f 不走整数路径, 保证往返后位模式一致
+        const bool bInRange = Value >= -2147483648.0f && Value < 2147483648.0f;
+        if (bInRange && FMath::TruncToFloat(Value) == Value && !(Value == 0.0f && std::signbit(Value))) {
+            IntegralValue = static_cast<int32>(Value);
+            bIntegral = 1;
+        }
+    }
+    Ar.SerializeBits(&bIntegral, 1);
+    if (bIntegral) {
+        ArzDax::ZigZagInt(Ar, IntegralValue);
+        if (Ar.IsLoading()) Value = static_cast<float>(IntegralValue);
+    }
+    else {
+        Ar << Value;
+    }
+    bOutSuccess = true;
+    return true;
+}
+
+bool FDaxBuiltinVectorQ::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+    uint32 Mode = static_cast<uint32>(Quantization);
+    Ar.SerializeBits(&Mode, 2);
+    switch (Mode) {
+        case static_cast<uint32>(EDaxVectorQuantization::Unit):
+            Quantization = EDaxVectorQuantization::Unit;
+            bOutSuccess = SerializePackedVector<1, 20>(Value, Ar);
+            break;
+        case static_cast<uint32>(EDaxVectorQuantization::Decimeter):
+            Quantization = EDaxVectorQuantization::Decimeter;
+            bOutSuccess = SerializePackedVector<10, 24>(Value, Ar);
+            break;
+        case static_cast<uint32>(EDaxVectorQuantization::Centimeter):
+            Quantization = EDaxVectorQuantization::Centimeter;
+            bOutSuccess = SerializePackedVector<100, 30>(Value, Ar);
+            break;
+        default:
+            Ar.SetError();
+            bOutSuccess = false;
+            break;
+    }
+    return true;
+}
+
+bool FDaxBuiltinRotatorQ::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+    Value.SerializeCompressedShort(Ar);
+    bOutSuccess = true;
+    return true;
+}
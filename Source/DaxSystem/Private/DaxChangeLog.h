@@ -0,0 +1,104 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "DaxSystem/Private/DaxNodeID.h"
+
+namespace ArzDax {
+
+    // 修改操作种类: 决定监听收到的变化种类(新建/移除/值变化), 变更日志本身只记录槽位
+    enum class EDaxChangeOp : uint8 {
+        AddNode = 0,
+        RemoveNode = 1,
+        Value = 2,       // 值变化
+        Struct = 3,      // 节点类型/容器结构变化
+        ArraySplice = 4,
+        MapPut = 5,
+        MapErase = 6,
+    };
+
+    struct FDaxChangeLogEntry {
+        uint32 DataVersion = 0; // 记录时容器的 DataVersion, 该条目表示 "在此版本之后发生的变化"
+        FDaxNodeID ID {};
+    };
+
+    // 服务端变更日志: 固定容量的环形缓冲, 按 DataVersion 递增写入.
+    // 连接确认的版本只要还在环内, 就可以只重放这之后触达的节点, 不再整表比较.
+    // 重放只需要槽位, 条目不保存操作种类.
+    class FDaxChangeLog {
+    public:
+        // 改变容量会丢弃已有记录; 容量为 0 时不记录.
+        // 由第一次服务端写出设置容量, 存储在之后第一次记录时才分配, 客户端与 CDO 的容器不会占用这块内存
+        FORCEINLINE void SetCapacity(const int32 InCapacity, const uint32 CurrentVersion) {
+            const int32 NewCapacity = FMath::Max(InCapacity, 16);
+            if (NewCapacity == Capacity) return;
+            Capacity = NewCapacity;
+            Entries.Empty();
+            Invalidate(CurrentVersion);
+        }
+
+        FORCEINLINE int32 GetCapacity() const { return Capacity; }
+
+        FORCEINLINE void Record(const uint32 DataVersion, const FDaxNodeID ID) {
+            if (Capacity == 0) return;
+            if (Entries.Num() != Capacity) Entries.SetNum(Capacity);
+            if (Count > 0) { // 连续对同一节点的记录合并为一条, 保留较新的版本
+                FDaxChangeLogEntry& Last = Entries[(Head + Count - 1) % Entries.Num()];
+                if (Last.ID == ID) {
+                    Last.DataVersion = DataVersion;
+                    return;
+                }
+            }
+            if (Count == Entries.Num()) { // 环满, 淘汰最旧的条目, 早于它的连接不再被覆盖
+                FloorVersion = FMath::Max(FloorVersion, Entries[Head].DataVersion + 1);
+                Head = (Head + 1) % Entries.Num();
+                --Count;
+            }
+            Entries[(Head + Count) % Entries.Num()] = FDaxChangeLogEntry{DataVersion, ID};
+            ++Count;
+        }
+
+        // 丢弃所有记录, 版本 <= DataVersion 的连接都必须走回退路径
+        FORCEINLINE void Invalidate(const uint32 DataVersion) {
+            Head = 0;
+            Count = 0;
+            FloorVersion = DataVersion + 1;
+        }
+
+        FORCEINLINE bool Covers(const uint32 AckedVersion) const {
+            return Capacity > 0 && AckedVersion >= FloorVersion;
+        }
+
+        // 遍历 AckedVersion 之后(含)记录的条目, 环不覆盖时返回 false.
+        // 条目按版本单调写入, 先二分找到起点, 开销只与变化量相关.
+        template <typename Func>
+        bool ForEachSince(const uint32 AckedVersion, Func&& Function) const {
+            if (!Covers(AckedVersion)) return false;
+            int32 Low = 0;
+            int32 High = Count;
+            while (Low < High) {
+                const int32 Mid = (Low + High) >> 1;
+                if (At(Mid).DataVersion < AckedVersion) Low = Mid + 1;
+                else High = Mid;
+            }
+            for (int32 i = Low; i < Count; ++i) {
+                Function(At(i));
+            }
+            return true;
+        }
+
+    private:
+        FORCEINLINE const FDaxChangeLogEntry& At(const int32 LogicalIndex) const {
+            return Entries[(Head + LogicalIndex) % Entries.Num()];
+        }
+
+        TArray<FDaxChangeLogEntry> Entries {};
+
+        int32 Capacity = 0;
+
+        int32 Head = 0;
+
+        int32 Count = 0;
+
+        uint32 FloorVersion = 0; // 能够被环覆盖的最小确认版本
+    };
+}
@@ -48,7 +48,7 @@ namespace ArzDax {
     // bit3: 值类型是否包含有效负载（HasValuePayload）
     // bit2: 容器是否以增量方式编码（HasContainerDelta）
     // bit1: 容器是否以全量方式编码（IsFullContainer）
-    // bit0: 保留
+    // bit0: 值负载为属性级增量（HasPropertyDelta, 仅与 HasValuePayload 同时出现）
     enum class EDaxDeltaOp : uint8 { Remove = 0, Add = 1, Update = 2 };
 
     enum : uint8 {
@@ -59,6 +59,7 @@ namespace ArzDax {
         DAX_DELTA_FLAG_VALUE = 0x08,
         DAX_DELTA_FLAG_CDELTA = 0x04,
         DAX_DELTA_FLAG_CFULL = 0x02,
+        DAX_DELTA_FLAG_PROPDELTA = 0x01,
     };
 
     static inline uint8 DaxMakeDeltaFlags(EDaxDeltaOp Op, bool bHasParent, bool bHasType, bool bHasValuePayload, bool bHasContainerDelta, bool bIsFullContainer) {
@@ -80,6 +81,7 @@ namespace ArzDax {
     static inline bool DaxFlagHasValue(uint8 Flags) { return (Flags & DAX_DELTA_FLAG_VALUE) != 0; }
     static inline bool DaxFlagHasCDelta(uint8 Flags) { return (Flags & DAX_DELTA_FLAG_CDELTA) != 0; }
     static inline bool DaxFlagIsCFull(uint8 Flags) { return (Flags & DAX_DELTA_FLAG_CFULL) != 0; }
+    static inline bool DaxFlagHasPropDelta(uint8 Flags) { return (Flags & DAX_DELTA_FLAG_PROPDELTA) != 0; }
 }
 
 
@@ -1,5 +1,8 @@
 ﻿#include "DaxSystem/Public/DaxComponent.h"
 #include "DaxSystem/Public/DaxSubsystem.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/Actor.h"
+#include "Net/Core/PushModel/PushModel.h"
 #include "Net/UnrealNetwork.h"
 
 UDaxComponent::UDaxComponent() {
@@ -12,7 +15,9 @@ void UDaxComponent::GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>&
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
     FDoRepLifetimeParams SharedParams{};
     SharedParams.bIsPushBased = true;
+    SharedParams.Condition = COND_Custom;
     DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, DataSet, SharedParams);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ThisClass, IrisState, SharedParams);
 }
 
 void UDaxComponent::OnRegister() {
@@ -24,6 +29,20 @@ void UDaxComponent::OnRegister() {
     }
 }
 
+void UDaxComponent::PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) {
+    Super::PreReplication(ChangedPropertyTracker);
+    // 两条复制路径只激活一条. OnRegister 时 NetDriver 可能还没有创建, 复制真正开始时才能确定用哪条
+    const bool bIris = IsUsingIrisReplication();
+    if (bReplicationPathChosen && bIrisPathActive == bIris) return;
+    bReplicationPathChosen = true;
+    bIrisPathActive = bIris;
+    DOREPCUSTOMCONDITION_SETACTIVE_FAST(UDaxComponent, DataSet, !bIris);
+    DOREPCUSTOMCONDITION_SETACTIVE_FAST(UDaxComponent, IrisState, bIris);
+    if (!bIris) return;
+    ensureMsgf(!DataSet.HasNetConditions(), TEXT("DaxComponent %s: net conditions are not enforced under Iris replication"), *GetPathName());
+    UpdateIrisState(); // 首次复制之前量化初始状态
+}
+
 void UDaxComponent::OnUnregister() {
     if (UWorld* W = GetWorld()) {
         if (UDaxSubsystem* Sys = W->GetSubsystem<UDaxSubsystem>()) {
@@ -33,11 +52,67 @@ void UDaxComponent::OnUnregister() {
     Super::OnUnregister();
 }
 
-bool UDaxComponent::BindOnChanged(const FDaxVisitor& Position, const int32 Depth, UObject* Target, const FName& FuncName) {
-    FDaxOnChangedDynamic Delegate;
-    Delegate.BindUFunction(Target, FuncName);
-    if (!Delegate.IsBound()) return false;
-    return DataSet.BindOnChanged(Position, Depth, Delegate);
+namespace {
+    // 脚本/蓝图监听: 绑定时解析一次函数并检查签名, 省掉动态委托每次调用时的按名查找.
+    // 每次派发仍要构造访问器、拷贝变化列表并经 ProcessEvent 组装参数帧; 对开销敏感的监听在 C++ 中用 FDaxSet::BindOnChangedNative
+    UFunction* FindListenerFunction(UObject* Target, const FName FuncName, const int32 NumParms) {
+        if (!IsValid(Target)) return nullptr;
+        UFunction* Function = Target->FindFunction(FuncName);
+        if (!Function || Function->NumParms != NumParms || Function->ReturnValueOffset != MAX_uint16) return nullptr;
+        TFieldIterator<FProperty> It(Function);
+        const FStructProperty* PositionProperty = It ? CastField<FStructProperty>(*It) : nullptr;
+        if (!PositionProperty || PositionProperty->Struct != FDaxVisitor::StaticStruct()) return nullptr;
+        if (NumParms == 2) {
+            ++It;
+            const FArrayProperty* ChangesProperty = It ? CastField<FArrayProperty>(*It) : nullptr;
+            const FStructProperty* RecordProperty = ChangesProperty ? CastField<FStructProperty>(ChangesProperty->Inner) : nullptr;
+            if (!RecordProperty || RecordProperty->Struct != FDaxChangeRecord::StaticStruct()) return nullptr;
+        }
+        return Function;
+    }
+
+    void InvokeListenerFunction(UObject* Target, UFunction* Function, const FDaxVisitor& Position, const TConstArrayView<FDaxChangeRecord>* Changes) {
+        uint8* Parms = static_cast<uint8*>(FMemory_Alloca_Aligned(Function->ParmsSize, Function->GetMinAlignment()));
+        Function->InitializeStruct(Parms);
+        TFieldIterator<FProperty> It(Function);
+        It->CopySingleValue(It->ContainerPtrToValuePtr<void>(Parms), &Position);
+        if (Changes) {
+            ++It;
+            *It->ContainerPtrToValuePtr<TArray<FDaxChangeRecord>>(Parms) = TArray<FDaxChangeRecord>(*Changes);
+        }
+        Target->ProcessEvent(Function, Parms);
+        Function->DestroyStruct(Parms);
+    }
+}
+
+bool UDaxComponent::BindOnChanged(const FDaxVisitor& Position, const int32 Depth, UObject* Target, const FName& FuncName, const bool bCaptureOldValues) {
+    UFunction* Function = FindListenerFunction(Target, FuncName, 1);
+    if (!Function) return false;
+    const TWeakObjectPtr<UObject> WeakTarget = Target;
+    const TWeakObjectPtr<UFunction> WeakFunction = Function;
+    return DataSet.BindOnChangedNative(Position, Depth, FDaxOnChangedNative::CreateWeakLambda(Target,
+        [WeakTarget, WeakFunction, Position](const FDaxSet& Set, const FDaxNodeID ChangedID) {
+            UObject* Object = WeakTarget.Get();
+            UFunction* Func = WeakFunction.Get();
+            if (!Object || !Func) return;
+            FDaxVisitor ChangePosition = Set.GetVisitorFromNodeID(ChangedID);
+            if (!ChangePosition.IsValid()) ChangePosition = Position;
+            InvokeListenerFunction(Object, Func, ChangePosition, nullptr);
+        }), bCaptureOldValues).IsValid();
+}
+
+bool UDaxComponent::BindOnChangedAggregate(const FDaxVisitor& Position, const int32 Depth, UObject* Target, const FName& FuncName, const bool bCaptureOldValues) {
+    UFunction* Function = FindListenerFunction(Target, FuncName, 2);
+    if (!Function) return false;
+    const TWeakObjectPtr<UObject> WeakTarget = Target;
+    const TWeakObjectPtr<UFunction> WeakFunction = Function;
+    return DataSet.BindOnChangedAggregateNative(Position, Depth, FDaxOnChangedAggregateNative::CreateWeakLambda(Target,
+        [WeakTarget, WeakFunction, Position](const FDaxSet&, FDaxNodeID, const TConstArrayView<FDaxChangeRecord> Changes) {
+            UObject* Object = WeakTarget.Get();
+            UFunction* Func = WeakFunction.Get();
+            if (!Object || !Func) return;
+            InvokeListenerFunction(Object, Func, Position, &Changes);
+        }), bCaptureOldValues).IsValid();
 }
 
 void UDaxComponent::UnbindOnChanged(const FDaxVisitor& Position) {
@@ -51,4 +126,62 @@ void UDaxComponent::UnbindAllFor(UObject* TargetObject) {
 void UDaxComponent::MarkDirty() {
     // 改为仅置位，由 Subsystem 统一 Flush，降低 Push 次数
     bPendingDirty = true;
-}
\ No newline at end of file
+}
+
+void UDaxComponent::FlushClientWrites() {
+    const AActor* Owner = GetOwner();
+    // 没有拥有者连接时 Server RPC 会被引擎丢弃, 这些预测只能等服务端自己触达
+    const bool bDeliver = WriteDelivery != EDaxWriteDelivery::Disabled && Owner && !Owner->HasAuthority() && Owner->GetNetConnection();
+    FDaxWriteBatch Batch;
+    if (!DataSet.ConsumeWriteBatch(Batch, bDeliver) || !bDeliver) return;
+    if (WriteDelivery == EDaxWriteDelivery::Reliable) ServerApplyWrites(Batch);
+    else ServerApplyWritesUnreliable(Batch);
+}
+
+void UDaxComponent::ServerApplyWrites_Implementation(const FDaxWriteBatch& Batch) {
+    ApplyClientWrites(Batch);
+}
+
+void UDaxComponent::ServerApplyWritesUnreliable_Implementation(const FDaxWriteBatch& Batch) {
+    ApplyClientWrites(Batch);
+}
+
+void UDaxComponent::ClientAckWrites_Implementation(const TArray<uint32>& RejectedKeys, const TArray<uint32>& UnchangedKeys) {
+    DataSet.AckPredictions(RejectedKeys, EDaxPredictionResult::Rejected);
+    DataSet.AckPredictions(UnchangedKeys, EDaxPredictionResult::Confirmed);
+}
+
+void UDaxComponent::ApplyClientWrites(const FDaxWriteBatch& Batch) {
+    TArray<uint32> Rejected;
+    TArray<uint32> Unchanged;
+    DataSet.ApplyWriteBatch(Batch, [this](const FDaxVisitor& Position, const FConstStructView NewValue) {
+        return WriteAuthority.IsBound() && WriteAuthority.Execute(this, Position, NewValue);
+    }, Rejected, Unchanged);
+    if (!Rejected.IsEmpty()) {
+        UE_LOGFMT(DataXSystem, Verbose, "DaxComponent {0}: rejected {1} of {2} client writes", *GetName(), Rejected.Num(), Batch.Entries.Num());
+    }
+    if (!Rejected.IsEmpty() || !Unchanged.IsEmpty()) ClientAckWrites(Rejected, Unchanged);
+}
+
+bool UDaxComponent::IsUsingIrisReplication() const {
+#if UE_WITH_IRIS
+    const UWorld* World = GetWorld();
+    const UNetDriver* Driver = World ? World->GetNetDriver() : nullptr;
+    return Driver && Driver->IsUsingIrisReplication();
+#else
+    return false;
+#endif
+}
+
+void UDaxComponent::UpdateIrisState() {
+#if UE_WITH_IRIS
+    const AActor* Owner = GetOwner();
+    if (!Owner || !Owner->HasAuthority() || !IsUsingIrisReplication()) return;
+    IrisState.State = DataSet.Iris_Quantize();
+    MARK_PROPERTY_DIRTY_FROM_NAME(UDaxComponent, IrisState, this);
+#endif
+}
+
+void UDaxComponent::OnRep_IrisState() {
+    if (IrisState.State.IsValid()) DataSet.Iris_Apply(*IrisState.State);
+}
@@ -0,0 +1,61 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "DaxSystem/Private/DaxAllocator.h"
+#include "Templates/RefCounting.h"
+
+namespace ArzDax {
+
+    // Iris 量化状态中的一个节点. 值在量化阶段就网络序列化成比特, 序列化阶段(可并行)不再访问容器本体
+    struct FDaxIrisSlot {
+        uint16 Generation = 0;
+
+        uint32 Version = 0; // 仅服务端使用, 判断槽位能否复用
+
+        FDaxNodeID Parent {};
+
+        const UScriptStruct* Type = nullptr;
+
+        TArray<uint8> Payload {};
+
+        uint32 PayloadBits = 0;
+
+        TArray<FDaxNodeID> Children {};
+
+        TArray<TPair<FName, FDaxNodeID>> Entries {};
+    };
+
+    struct FDaxIrisChunk {
+        uint32 UsedMask = 0;
+
+        TSharedPtr<const FDaxIrisSlot> Slots[DAX_NODE_POOR_CHUNK_SIZE] {};
+    };
+
+    // 整个容器的量化状态, 以引用计数在 Iris 的各份状态缓冲之间共享.
+    // 新状态只重建脏块, 块和槽位没有变化时直接复用旧指针, 增量序列化时指针相同即可跳过
+    class FDaxIrisState : public FRefCountBase {
+    public:
+        uint32 DataVersion = 0;
+
+        uint32 StructVersion = 0;
+
+        uint32 ChunkEpoch = 0;
+
+        uint32 PredictionWatermark = 0; // 服务端已处理到的客户端预测键
+
+        TArray<TSharedPtr<const FDaxIrisChunk>> Chunks {};
+
+        FORCEINLINE const FDaxIrisChunk* GetChunk(const int32 ChunkIndex) const {
+            return Chunks.IsValidIndex(ChunkIndex) ? Chunks[ChunkIndex].Get() : nullptr;
+        }
+
+        FORCEINLINE static const FDaxIrisSlot* GetSlot(const FDaxIrisChunk* Chunk, const uint16 LocalIndex) {
+            if (!Chunk || (Chunk->UsedMask & (DAX_NODE_POOR_BASE_NUMBER << LocalIndex)) == 0) return nullptr;
+            return Chunk->Slots[LocalIndex].Get();
+        }
+
+        FORCEINLINE static FDaxNodeID MakeID(const int32 ChunkIndex, const uint16 LocalIndex, const uint16 Generation) {
+            return FDaxNodeID(static_cast<uint16>((ChunkIndex << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex), Generation);
+        }
+    };
+}
@@ -0,0 +1,156 @@
+﻿#include "DaxSystem/Private/DaxNetDictionary.h"
+#include "DaxSystem/Private/DaxCommon.h"
+#include "DaxSystem/Public/DaxBuiltinTypes.h"
+#include "UObject/CoreNet.h"
+
+using namespace ArzDax;
+
+namespace {
+    enum : uint8 {
+        TypeKindEmpty = 0,
+        TypeKindArray = 1,
+        TypeKindMap = 2,
+        TypeKindValue = 3,
+    };
+
+    constexpr uint32 BuiltinIndexBits = 4;
+
+    // 内置值类型的固定编号, 只能在末尾追加
+    TConstArrayView<const UScriptStruct*> GetBuiltinValueTypes() {
+        static const UScriptStruct* BuiltinTypes[] = {
+            FDaxBuiltinBool::StaticStruct(),
+            FDaxBuiltinInt64::StaticStruct(),
+            FDaxBuiltinFloat::StaticStruct(),
+            FDaxBuiltinName::StaticStruct(),
+            FDaxBuiltinString::StaticStruct(),
+            FDaxBuiltinVector::StaticStruct(),
+            FDaxBuiltinRotator::StaticStruct(),
+            FDaxBuiltinVectorQ::StaticStruct(),
+            FDaxBuiltinRotatorQ::StaticStruct(),
+        };
+        static_assert(UE_ARRAY_COUNT(BuiltinTypes) <= (1u << BuiltinIndexBits), "Too many builtin dax value types for the type code");
+        return BuiltinTypes;
+    }
+}
+
+void FDaxNetTypeCodec::Write(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, FDaxNetTypeWriter& Table) {
+    uint32 Kind = TypeKindValue;
+    if (Type == nullptr || Type == FDaxFakeTypeEmpty::StaticStruct()) Kind = TypeKindEmpty;
+    else if (Type == FDaxFakeTypeArray::StaticStruct()) Kind = TypeKindArray;
+    else if (Type == FDaxFakeTypeMap::StaticStruct()) Kind = TypeKindMap;
+    Ar.SerializeBits(&Kind, 2);
+    if (Kind != TypeKindValue) return;
+
+    const int32 BuiltinIndex = GetBuiltinValueTypes().Find(Type);
+    uint8 bBuiltin = BuiltinIndex != INDEX_NONE ? 1 : 0;
+    Ar.SerializeBits(&bBuiltin, 1);
+    if (bBuiltin) {
+        uint32 Code = static_cast<uint32>(BuiltinIndex);
+        Ar.SerializeBits(&Code, BuiltinIndexBits);
+        return;
+    }
+
+    uint32 Index = 0;
+    const EDaxNetDictionaryResult Result = Table.FindOrAdd(Type, Index);
+    uint8 bKnown = Result == EDaxNetDictionaryResult::Known ? 1 : 0;
+    Ar.SerializeBits(&bKnown, 1);
+    if (bKnown) {
+        Ar.SerializeIntPacked(Index);
+        return;
+    }
+    uint32 Slot = Result == EDaxNetDictionaryResult::Define ? Index + 1 : 0;
+    Ar.SerializeIntPacked(Slot);
+    UObject* TypeObject = const_cast<UScriptStruct*>(Type);
+    Map->SerializeObject(Ar, UScriptStruct::StaticClass(), TypeObject);
+}
+
+bool FDaxNetTypeCodec::Read(FArchive& Ar, UPackageMap* Map, FDaxNetTypeReader& Table, const UScriptStruct*& OutType) {
+    uint32 Kind = 0;
+    Ar.SerializeBits(&Kind, 2);
+    switch (Kind) {
+        case TypeKindEmpty: OutType = FDaxFakeTypeEmpty::StaticStruct(); return true;
+        case TypeKindArray: OutType = FDaxFakeTypeArray::StaticStruct(); return true;
+        case TypeKindMap: OutType = FDaxFakeTypeMap::StaticStruct(); return true;
+        default: break;
+    }
+
+    uint8 bBuiltin = 0;
+    Ar.SerializeBits(&bBuiltin, 1);
+    if (bBuiltin) {
+        uint32 Code = 0;
+        Ar.SerializeBits(&Code, BuiltinIndexBits);
+        const TConstArrayView<const UScriptStruct*> Builtins = GetBuiltinValueTypes();
+        if (!Builtins.IsValidIndex(static_cast<int32>(Code))) {
+            Ar.SetError();
+            return false;
+        }
+        OutType = Builtins[Code];
+        return true;
+    }
+
+    uint8 bKnown = 0;
+    Ar.SerializeBits(&bKnown, 1);
+    if (bKnown) {
+        uint32 Index = 0;
+        Ar.SerializeIntPacked(Index);
+        if (!Table.Resolve(Index, OutType)) {
+            UE_LOGFMT(DataXSystem, Error, "DaxNetTypeCodec: type index {0} referenced before definition", Index);
+            Ar.SetError();
+            return false;
+        }
+        return true;
+    }
+
+    uint32 Slot = 0;
+    Ar.SerializeIntPacked(Slot);
+    if (Slot > MaxUserTypes) {
+        Ar.SetError();
+        return false;
+    }
+    UObject* TypeObject = nullptr;
+    const bool bMapped = Map->SerializeObject(Ar, UScriptStruct::StaticClass(), TypeObject);
+    OutType = Cast<UScriptStruct>(TypeObject);
+    if (!bMapped || !OutType) return false;
+    if (Slot > 0) Table.Define(Slot - 1, OutType);
+    return true;
+}
+
+void FDaxNetKeyCodec::Write(FArchive& Ar, const FName Key, FDaxNetKeyWriter& Table) {
+    uint32 Index = 0;
+    const EDaxNetDictionaryResult Result = Table.FindOrAdd(Key, Index);
+    uint8 bKnown = Result == EDaxNetDictionaryResult::Known ? 1 : 0;
+    Ar.SerializeBits(&bKnown, 1);
+    if (bKnown) {
+        Ar.SerializeIntPacked(Index);
+        return;
+    }
+    uint32 Slot = Result == EDaxNetDictionaryResult::Define ? Index + 1 : 0;
+    Ar.SerializeIntPacked(Slot);
+    FName Temp = Key;
+    Ar << Temp;
+}
+
+bool FDaxNetKeyCodec::Read(FArchive& Ar, FDaxNetKeyReader& Table, FName& OutKey) {
+    uint8 bKnown = 0;
+    Ar.SerializeBits(&bKnown, 1);
+    if (bKnown) {
+        uint32 Index = 0;
+        Ar.SerializeIntPacked(Index);
+        if (!Table.Resolve(Index, OutKey)) {
+            UE_LOGFMT(DataXSystem, Error, "DaxNetKeyCodec: key index {0} referenced before definition", Index);
+            OutKey = NAME_None;
+            Ar.SetError();
+            return false;
+        }
+        return true;
+    }
+    uint32 Slot = 0;
+    Ar.SerializeIntPacked(Slot);
+    Ar << OutKey;
+    if (Slot > MaxKeys) {
+        Ar.SetError();
+        return false;
+    }
+    if (Slot > 0) Table.Define(Slot - 1, OutKey);
+    return true;
+}
@@ -0,0 +1,153 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UPackageMap;
+
+namespace ArzDax {
+
+    // 每个连接一份的网络字典(类型表/键名表共用).
+    // 服务端字典挂在 BaseState 上, 只读共享; 本次写入新增条目时才拷贝一份(写时复制).
+    // 新条目先记在 Unacked 里, 直到定义它的包被确认才转为只发下标; 在此之前每次写入都继续内联定义,
+    // 定义包丢失时后续包里的引用仍然自带定义, 客户端看到的永远是已定义的下标.
+    template <typename KeyType>
+    struct TDaxNetDictionary {
+        TMap<KeyType, uint32> Indices {};
+
+        TMap<KeyType, int32> Unacked {}; // 未确认条目 -> 定义所在 bunch 的最后一个包序号上界, INDEX_NONE 表示 bunch 尚未发出
+
+        uint32 Num = 0;
+    };
+
+    enum class EDaxNetDictionaryResult : uint8 {
+        Known,  // 连接已确认, 只发下标
+        Define, // 新分配或尚未确认的下标, 随本条记录内联定义
+        Inline, // 字典已满, 只内联发送不入表
+    };
+
+    template <typename KeyType>
+    class TDaxNetDictionaryWriter {
+    public:
+        using FDictionary = TDaxNetDictionary<KeyType>;
+
+        // OutPacketId: 连接当前正在填充的包序号; AckedPacketId: 连接已确认的最大包序号.
+        // 没有连接(或内部确认的回放连接)时传 AckedPacketId = MAX_int32, 定义在下一次写入时立即视为已确认
+        TDaxNetDictionaryWriter(const TSharedPtr<const FDictionary>& InBase, const uint32 InCapacity,
+                                const int32 InOutPacketId = 0, const int32 InAckedPacketId = MAX_int32)
+            : Base(InBase), Capacity(InCapacity) {
+            if (!Base.IsValid() || Base->Unacked.IsEmpty()) return;
+            // 上一次写入的 bunch 此时已经发出, 当前包序号就是它落入的最后一个包的上界;
+            // 只有确认了这个上界才说明整个 bunch(含拆分的部分 bunch)都已送达
+            auto NeedsUpdate = [&](const int32 DefinePacketId) {
+                return DefinePacketId == INDEX_NONE || DefinePacketId <= InAckedPacketId;
+            };
+            bool bDirty = false;
+            for (const auto& Pair : Base->Unacked) {
+                if (NeedsUpdate(Pair.Value)) {
+                    bDirty = true;
+                    break;
+                }
+            }
+            if (!bDirty) return;
+            Mutable = MakeShared<FDictionary>(*Base);
+            for (auto It = Mutable->Unacked.CreateIterator(); It; ++It) {
+                if (It.Value() == INDEX_NONE) It.Value() = InOutPacketId;
+                if (It.Value() <= InAckedPacketId) It.RemoveCurrent();
+            }
+        }
+
+        EDaxNetDictionaryResult FindOrAdd(const KeyType& Key, uint32& OutIndex) {
+            const FDictionary* Current = Mutable.IsValid() ? Mutable.Get() : Base.Get();
+            if (Current) {
+                if (const uint32* Found = Current->Indices.Find(Key)) {
+                    OutIndex = *Found;
+                    // 本次写入里已经内联定义过一次的条目, 后面的引用与定义在同一个 bunch 内, 只发下标即可
+                    if (!Current->Unacked.Contains(Key) || DefinedThisWrite.Contains(Key)) return EDaxNetDictionaryResult::Known;
+                    DefinedThisWrite.Add(Key);
+                    return EDaxNetDictionaryResult::Define;
+                }
+                if (Current->Num >= Capacity) return EDaxNetDictionaryResult::Inline;
+            }
+            if (!Mutable.IsValid()) Mutable = Base.IsValid() ? MakeShared<FDictionary>(*Base) : MakeShared<FDictionary>();
+            OutIndex = Mutable->Num++;
+            Mutable->Indices.Add(Key, OutIndex);
+            Mutable->Unacked.Add(Key, INDEX_NONE);
+            DefinedThisWrite.Add(Key);
+            return EDaxNetDictionaryResult::Define;
+        }
+
+        // 写入结束后交给 NewState 的字典, 没有新增时继续共享旧字典
+        TSharedPtr<const FDictionary> Finish() const {
+            return Mutable.IsValid() ? TSharedPtr<const FDictionary>(Mutable) : Base;
+        }
+
+    private:
+        TSharedPtr<const FDictionary> Base {};
+
+        TSharedPtr<FDictionary> Mutable {};
+
+        TSet<KeyType> DefinedThisWrite {};
+
+        uint32 Capacity = 0;
+    };
+
+    // 客户端侧: 按下标存放服务端定义过的条目, 收到定义即覆盖
+    template <typename KeyType>
+    struct TDaxNetDictionaryReader {
+        TArray<KeyType> Slots {};
+
+        TBitArray<> Defined {};
+
+        FORCEINLINE void Reset() {
+            Slots.Reset();
+            Defined.Reset();
+        }
+
+        FORCEINLINE bool Resolve(const uint32 Index, KeyType& OutKey) const {
+            if (!Defined.IsValidIndex(static_cast<int32>(Index)) || !Defined[Index]) return false;
+            OutKey = Slots[Index];
+            return true;
+        }
+
+        FORCEINLINE void Define(const uint32 Index, const KeyType& Key) {
+            if (Slots.Num() <= static_cast<int32>(Index)) {
+                Slots.SetNum(Index + 1);
+                Defined.Add(false, Index + 1 - Defined.Num());
+            }
+            Slots[Index] = Key;
+            Defined[Index] = true;
+        }
+    };
+
+    using FDaxNetTypeDictionary = TDaxNetDictionary<const UScriptStruct*>;
+    using FDaxNetTypeWriter = TDaxNetDictionaryWriter<const UScriptStruct*>;
+    using FDaxNetTypeReader = TDaxNetDictionaryReader<const UScriptStruct*>;
+
+    // 节点类型编码:
+    // 2bit 种类(Empty/Array/Map/Value) -> Value: 1bit 是否内置 -> 内置: 4bit 固定编号
+    //                                                       -> 用户: 1bit 已确认 -> 已确认: 下标
+    //                                                                            -> 未确认: (下标+1 | 0=不入表) + SerializeObject
+    struct FDaxNetTypeCodec {
+        static constexpr uint32 MaxUserTypes = 1024;
+
+        static void Write(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, FDaxNetTypeWriter& Table);
+
+        // 返回 false 表示类型对象尚未映射, 调用方需要推迟读取
+        static bool Read(FArchive& Ar, UPackageMap* Map, FDaxNetTypeReader& Table, const UScriptStruct*& OutType);
+    };
+
+    using FDaxNetKeyDictionary = TDaxNetDictionary<FName>;
+    using FDaxNetKeyWriter = TDaxNetDictionaryWriter<FName>;
+    using FDaxNetKeyReader = TDaxNetDictionaryReader<FName>;
+
+    // Map 键名编码: 1bit 已确认 -> 已确认: 下标
+    //                          -> 未确认: (下标+1 | 0=不入表) + FName
+    struct FDaxNetKeyCodec {
+        static constexpr uint32 MaxKeys = 2048;
+
+        static void Write(FArchive& Ar, const FName Key, FDaxNetKeyWriter& Table);
+
+        // 返回 false 表示引用了未定义的下标, Ar 已被标记为错误
+        static bool Read(FArchive& Ar, FDaxNetKeyReader& Table, FName& OutKey);
+    };
+}
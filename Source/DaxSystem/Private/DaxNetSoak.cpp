@@ -0,0 +1,430 @@
+﻿#include "DaxSystem/Private/DaxSet.h"
+#include "DaxSystem/Private/DaxCommon.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Parse.h"
+#include "UObject/CoreNet.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace {
+    // 复制浸泡测试: 服务端容器每帧随机修改, 经 NetDeltaSerialize 写出后按模拟的延迟/丢包/乱序交给客户端容器.
+    // 基线管理仿照引擎的自定义增量属性:
+    //  - 打开通道的初始包是可靠包, 丢失时以新的包序号重发同一份数据; 初始包确认之前每次写出都以空基线重发全部数据
+    //  - 之后以最近一次发送的状态为基线, 收到丢包回执时退回最近确认的状态
+    //  - 客户端丢弃比已收到的包序号更旧的包, 发送端随后收到丢包回执
+    //  - 回执丢失时已送达的包也按丢包处理, 退回后的增量会重复携带客户端已经应用过的修改
+    // 只使用内置值类型, 不需要 PackageMap; 量化类型(VectorQ/RotatorQ)往返有损, 不参与收敛比较.
+    struct FDaxSoakConfig {
+        int32 Frames = 600;
+        int32 Seed = 1;
+        float Loss = 0.1f;
+        float Reorder = 0.05f;
+        float AckLoss = 0.f; // 已送达的包回执丢失的概率
+        int32 Latency = 3;   // 单程延迟(帧)
+        int32 Ops = 8;       // 每帧最多的修改次数
+        int32 SettleFrames = 600;
+    };
+
+    struct FDaxSoakPacket {
+        int32 Sequence = 0;
+        int32 DeliverFrame = 0;
+        bool bLost = false;
+        bool bReliable = false;
+        TArray<uint8> Data {};
+        int64 NumBits = 0;
+    };
+
+    struct FDaxSoakReceipt {
+        int32 Sequence = 0;
+        int32 ArriveFrame = 0;
+        bool bAcked = false;
+        bool bReliable = false;
+        TSharedPtr<INetDeltaBaseState> State {};
+        TArray<uint8> Data {}; // 可靠包重发用
+        int64 NumBits = 0;
+    };
+
+    struct FDaxSoakStats {
+        int32 Packets = 0;
+        int32 Lost = 0;
+        int32 AckLost = 0;
+        int32 DroppedOutOfOrder = 0;
+        int32 DroppedBeforeOpen = 0;
+        int32 Duplicates = 0;
+        int32 Retransmits = 0;
+        int32 Naks = 0;
+        int64 TotalBits = 0;
+        int64 MaxBits = 0;
+        int32 MutationFrames = 0;
+        int64 TotalOps = 0;
+        int32 MaxOps = 0;
+    };
+
+    struct FDaxSoakResult {
+        bool bSettled = false;
+        bool bReadFailed = false;
+        uint32 ServerNodes = 0;
+        uint32 ClientNodes = 0;
+        FString ServerText {};
+        FString ClientText {};
+
+        bool IsConverged() const { return bSettled && !bReadFailed && ServerNodes == ClientNodes && ServerText == ClientText; }
+    };
+
+    FName MakeKey(const TCHAR* Prefix, const int32 Index) {
+        return FName(*FString::Printf(TEXT("%s%d"), Prefix, Index));
+    }
+
+    void SetRandomValue(const FDaxVisitor& Target, FRandomStream& Rng) {
+        switch (Rng.RandRange(0, 5)) {
+            case 0: Target.EnsureAndSetBool(Rng.RandRange(0, 1) != 0); break;
+            case 1: Target.EnsureAndSetInt(static_cast<int64>(Rng.RandRange(-100000, 100000))); break;
+            case 2: Target.EnsureAndSetFloat(Rng.FRandRange(-1000.f, 1000.f)); break;
+            case 3: Target.EnsureAndSetName(MakeKey(TEXT("n"), Rng.RandRange(0, 15))); break;
+            case 4: Target.EnsureAndSetString(FString::ChrN(Rng.RandRange(0, 24), TEXT('a') + Rng.RandRange(0, 25))); break;
+            default: Target.EnsureAndSetVector(FVector(Rng.FRandRange(-1e4f, 1e4f), Rng.FRandRange(-1e4f, 1e4f), Rng.FRandRange(-1e4f, 1e4f))); break;
+        }
+    }
+
+    // 随机挑一个 Map 容器: 根, 一级子 Map, 二级子 Map
+    FDaxVisitor PickMap(const FDaxVisitor& Root, FRandomStream& Rng) {
+        switch (Rng.RandRange(0, 2)) {
+            case 0: return Root;
+            case 1: return Root[MakeKey(TEXT("m"), Rng.RandRange(0, 3))].EnsureMap();
+            default: return Root[MakeKey(TEXT("m"), Rng.RandRange(0, 3))].EnsureMap()[MakeKey(TEXT("s"), Rng.RandRange(0, 3))].EnsureMap();
+        }
+    }
+
+    void MutateOnce(FDaxSet& Server, FRandomStream& Rng) {
+        const FDaxVisitor Root = Server.GetVisitor().EnsureMap();
+        const FDaxVisitor Array = Root[MakeKey(TEXT("a"), Rng.RandRange(0, 2))].EnsureArray();
+        const int32 Op = Rng.RandRange(0, 99);
+        if (Op < 40) {
+            SetRandomValue(PickMap(Root, Rng)[MakeKey(TEXT("k"), Rng.RandRange(0, 11))], Rng);
+        }
+        else if (Op < 52) {
+            const FDaxVisitor Added = Array.ArrayAdd();
+            if (Rng.RandRange(0, 3) == 0) SetRandomValue(Added.EnsureMap()[MakeKey(TEXT("k"), Rng.RandRange(0, 3))], Rng);
+            else SetRandomValue(Added, Rng);
+        }
+        else if (Op < 60) {
+            SetRandomValue(Array.ArrayInsert(Rng.RandRange(0, FMath::Max(Array.ArrayNum(), 0))), Rng);
+        }
+        else if (Op < 70) {
+            Array.ArrayRemove();
+        }
+        else if (Op < 80) {
+            const int32 Num = Array.ArrayNum();
+            if (Num > 0) SetRandomValue(Array[Rng.RandRange(0, Num - 1)], Rng);
+        }
+        else if (Op < 92) {
+            PickMap(Root, Rng).MapRemove(MakeKey(TEXT("k"), Rng.RandRange(0, 11)));
+        }
+        else if (Op < 96) {
+            Array.ArrayClear();
+        }
+        else {
+            Root[MakeKey(TEXT("m"), Rng.RandRange(0, 3))].TrySetToEmpty(); // 整棵子树替换为空节点
+        }
+    }
+
+    // Map 子节点按键名排序, 与两端的内部存储顺序和节点分配无关
+    void DumpCanonical(const FDaxVisitor& Node, FString& Out) {
+        if (Node.IsAEmptyMap() || Node.IsANoEmptyMap()) {
+            TArray<TPair<FString, FDaxVisitor>> Children;
+            for (const FDaxVisitor& Child : Node.MapGetChildren()) Children.Emplace(Child.GetKeyInParentMap().ToString(), Child);
+            Children.Sort([](const TPair<FString, FDaxVisitor>& A, const TPair<FString, FDaxVisitor>& B) { return A.Key < B.Key; });
+            Out += TEXT("{");
+            for (const TPair<FString, FDaxVisitor>& Pair : Children) {
+                Out += Pair.Key;
+                Out += TEXT(":");
+                DumpCanonical(Pair.Value, Out);
+                Out += TEXT(",");
+            }
+            Out += TEXT("}");
+            return;
+        }
+        if (Node.IsAEmptyArray() || Node.IsANoEmptyArray()) {
+            Out += TEXT("[");
+            for (const FDaxVisitor& Child : Node.ArrayGetChildren()) {
+                DumpCanonical(Child, Out);
+                Out += TEXT(",");
+            }
+            Out += TEXT("]");
+            return;
+        }
+        if (Node.IsAEmptyNode()) {
+            Out += TEXT("~");
+            return;
+        }
+        const FConstStructView Value = Node.TryGetValueGeneric();
+        if (!Value.IsValid() || !Value.GetScriptStruct()) {
+            Out += TEXT("<invalid>");
+            return;
+        }
+        FString Text;
+        Value.GetScriptStruct()->ExportText(Text, Value.GetMemory(), nullptr, nullptr, PPF_None, nullptr);
+        Out += Value.GetScriptStruct()->GetName();
+        Out += Text;
+    }
+
+    FString GetCanonicalString(const FDaxSet& Set) {
+        FString Out;
+        DumpCanonical(Set.GetVisitor(), Out);
+        return Out;
+    }
+
+    FDaxSoakResult RunSoak(const FDaxSoakConfig& Config) {
+        FDaxSet Server;
+        FDaxSet Client;
+        FRandomStream Rng(Config.Seed);
+        FDaxSoakStats Stats;
+        FDaxSoakResult Result;
+
+        TArray<FDaxSoakPacket> InFlight;
+        TArray<FDaxSoakReceipt> Receipts;
+        TSharedPtr<INetDeltaBaseState> RecentState;
+        TSharedPtr<INetDeltaBaseState> AckedState;
+        int32 NextSequence = 0;
+        int32 AckedSequence = INDEX_NONE;
+        int32 LastDelivered = INDEX_NONE;
+        bool bOpenSent = false;
+        bool bClientOpened = false;
+
+        // 发出一个包并登记回执; 丢包/乱序/回执丢失只在修改阶段抽取, 收敛阶段的链路是无损的
+        auto SendPacket = [&](const int32 Frame, const bool bLossy, const bool bReliable, const TArray<uint8>& Data, const int64 NumBits,
+                              const TSharedPtr<INetDeltaBaseState>& State) {
+            FDaxSoakPacket& Packet = InFlight.AddDefaulted_GetRef();
+            Packet.Sequence = NextSequence++;
+            Packet.DeliverFrame = Frame + Config.Latency;
+            Packet.bReliable = bReliable;
+            if (bLossy) {
+                Packet.bLost = Rng.FRand() < Config.Loss;
+                if (Rng.FRand() < Config.Reorder) Packet.DeliverFrame += Rng.RandRange(1, 3);
+            }
+            Packet.Data = Data;
+            Packet.NumBits = NumBits;
+
+            FDaxSoakReceipt& Receipt = Receipts.AddDefaulted_GetRef();
+            Receipt.Sequence = Packet.Sequence;
+            Receipt.ArriveFrame = Packet.DeliverFrame + Config.Latency;
+            Receipt.bAcked = !Packet.bLost;
+            if (Receipt.bAcked && bLossy && Rng.FRand() < Config.AckLoss) {
+                Receipt.bAcked = false;
+                ++Stats.AckLost;
+            }
+            Receipt.bReliable = bReliable;
+            Receipt.State = State;
+            if (bReliable) {
+                Receipt.Data = Data;
+                Receipt.NumBits = NumBits;
+            }
+        };
+        auto NakReceipt = [&](const int32 Sequence) {
+            for (FDaxSoakReceipt& Receipt : Receipts) {
+                if (Receipt.Sequence == Sequence) Receipt.bAcked = false;
+            }
+        };
+
+        const int32 MaxFrames = Config.Frames + Config.SettleFrames;
+        for (int32 Frame = 0; Frame < MaxFrames; ++Frame) {
+            const bool bSettling = Frame >= Config.Frames;
+
+            if (!bSettling) {
+                const int32 Ops = Rng.RandRange(0, Config.Ops);
+                for (int32 i = 0; i < Ops; ++i) MutateOnce(Server, Rng);
+                ++Stats.MutationFrames;
+                Stats.TotalOps += Ops;
+                Stats.MaxOps = FMath::Max(Stats.MaxOps, Ops);
+            }
+
+            // 发送端与引擎一样严格按包序号处理回执(回执表按序号追加): 一个包的回执要等之前所有包的回执都到达,
+            // 丢包回执因此总是先于后续包的确认. 确认推进基线; 不可靠包的丢包回执让基线退回最近确认的状态;
+            // 可靠包不回退基线, 以新的包序号重发
+            int32 DueNum = 0;
+            while (DueNum < Receipts.Num() && Receipts[DueNum].ArriveFrame <= Frame) ++DueNum;
+            TArray<FDaxSoakReceipt> Due;
+            for (int32 i = 0; i < DueNum; ++i) Due.Add(MoveTemp(Receipts[i]));
+            Receipts.RemoveAt(0, DueNum, EAllowShrinking::No);
+            for (FDaxSoakReceipt& Receipt : Due) {
+                if (Receipt.bAcked) {
+                    if (Receipt.Sequence > AckedSequence) {
+                        AckedSequence = Receipt.Sequence;
+                        AckedState = Receipt.State;
+                    }
+                }
+                else if (Receipt.bReliable) {
+                    ++Stats.Retransmits;
+                    SendPacket(Frame, !bSettling, true, Receipt.Data, Receipt.NumBits, Receipt.State);
+                }
+                else if (Receipt.Sequence > AckedSequence) {
+                    RecentState = AckedState;
+                    ++Stats.Naks;
+                }
+            }
+
+            // 服务端写出本帧的包; 初始包确认之前没有可用的基线
+            FNetBitWriter Writer(nullptr, 0);
+            TSharedPtr<INetDeltaBaseState> NewState;
+            FNetDeltaSerializeInfo WriteParms;
+            WriteParms.Writer = &Writer;
+            WriteParms.OldState = AckedState.IsValid() ? RecentState.Get() : nullptr;
+            WriteParms.NewState = &NewState;
+            const bool bWrote = Server.NetDeltaSerialize(WriteParms) && NewState.IsValid();
+            if (bWrote) {
+                const bool bReliable = !bOpenSent;
+                bOpenSent = true;
+                SendPacket(Frame, !bSettling, bReliable, *Writer.GetBuffer(), Writer.GetNumBits(), NewState);
+                RecentState = NewState;
+                ++Stats.Packets;
+                Stats.TotalBits += Writer.GetNumBits();
+                Stats.MaxBits = FMath::Max(Stats.MaxBits, Writer.GetNumBits());
+            }
+
+            // 客户端按到达顺序读取
+            InFlight.StableSort([](const FDaxSoakPacket& A, const FDaxSoakPacket& B) { return A.DeliverFrame < B.DeliverFrame; });
+            while (InFlight.Num() > 0 && InFlight[0].DeliverFrame <= Frame) {
+                const FDaxSoakPacket Packet = MoveTemp(InFlight[0]);
+                InFlight.RemoveAt(0, 1, EAllowShrinking::No);
+                if (Packet.bLost) {
+                    ++Stats.Lost;
+                    continue;
+                }
+                if (Packet.Sequence < LastDelivered) {
+                    ++Stats.DroppedOutOfOrder;
+                    NakReceipt(Packet.Sequence);
+                    continue;
+                }
+                LastDelivered = Packet.Sequence;
+                if (Packet.bReliable) {
+                    // 回执丢失引起的重发, 通道已经打开, 按可靠序号丢弃重复的初始包
+                    if (bClientOpened) {
+                        ++Stats.Duplicates;
+                        continue;
+                    }
+                    bClientOpened = true;
+                }
+                else if (!bClientOpened) {
+                    // 通道打开之前到达的属性数据不会被处理, 不能让发送端以它为基线
+                    ++Stats.DroppedBeforeOpen;
+                    NakReceipt(Packet.Sequence);
+                    continue;
+                }
+
+                FNetBitReader Reader(nullptr, const_cast<uint8*>(Packet.Data.GetData()), Packet.NumBits);
+                FNetDeltaSerializeInfo ReadParms;
+                ReadParms.Reader = &Reader;
+                Client.NetDeltaSerialize(ReadParms);
+                if (Reader.IsError()) {
+                    UE_LOGFMT(DataXSystem, Error, "DaxNetSoak: client read failed at frame {0}, packet {1}", Frame, Packet.Sequence);
+                    Result.bReadFailed = true;
+                    return Result;
+                }
+            }
+
+            // 监听者每帧结算后清理, 这里没有监听者, 直接清理
+            Server.ClearFrameChangedNodes();
+            Client.ClearFrameChangedNodes();
+
+            if (bSettling && !bWrote && InFlight.IsEmpty() && Receipts.IsEmpty() && RecentState == AckedState) {
+                Result.bSettled = true;
+                break;
+            }
+        }
+
+        const int32 Delivered = Stats.Packets + Stats.Retransmits - Stats.Lost - Stats.DroppedOutOfOrder - Stats.DroppedBeforeOpen - Stats.Duplicates;
+        UE_LOGFMT(DataXSystem, Display, "DaxNetSoak: seed={0} frames={1} packets={2} retransmits={3} lost={4} ackLost={5} outOfOrder={6} beforeOpen={7} duplicates={8} naks={9} delivered={10}",
+                  Config.Seed, Config.Frames, Stats.Packets, Stats.Retransmits, Stats.Lost, Stats.AckLost, Stats.DroppedOutOfOrder, Stats.DroppedBeforeOpen,
+                  Stats.Duplicates, Stats.Naks, Delivered);
+        UE_LOGFMT(DataXSystem, Display, "DaxNetSoak: bits/frame avg={0} max={1}, ops/frame avg={2} max={3}, nodes={4}",
+                  Stats.TotalBits / FMath::Max(Config.Frames, 1), Stats.MaxBits,
+                  static_cast<double>(Stats.TotalOps) / FMath::Max(Stats.MutationFrames, 1), Stats.MaxOps, Server.GetNodeNum());
+
+        Result.ServerNodes = Server.GetNodeNum();
+        Result.ClientNodes = Client.GetNodeNum();
+        Result.ServerText = GetCanonicalString(Server);
+        Result.ClientText = GetCanonicalString(Client);
+        return Result;
+    }
+
+    // 用法: Dax.Net.Soak Frames=600 Seed=1 Loss=0.1 Reorder=0.05 AckLoss=0 Latency=3 Ops=8 Runs=1
+    // 自动化测试 DaxSystem.Net.Soak 覆盖固定的几组链路配置
+    FAutoConsoleCommand GDaxNetSoakCommand(
+        TEXT("Dax.Net.Soak"),
+        TEXT("Runs a randomized replication soak between an in-memory server and client DaxSet with simulated latency, loss and reordering, then checks convergence."),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args) {
+            const FString Line = FString::Join(Args, TEXT(" "));
+            FDaxSoakConfig Config;
+            FParse::Value(*Line, TEXT("Frames="), Config.Frames);
+            FParse::Value(*Line, TEXT("Seed="), Config.Seed);
+            FParse::Value(*Line, TEXT("Loss="), Config.Loss);
+            FParse::Value(*Line, TEXT("Reorder="), Config.Reorder);
+            FParse::Value(*Line, TEXT("AckLoss="), Config.AckLoss);
+            FParse::Value(*Line, TEXT("Latency="), Config.Latency);
+            FParse::Value(*Line, TEXT("Ops="), Config.Ops);
+            FParse::Value(*Line, TEXT("Settle="), Config.SettleFrames);
+            int32 Runs = 1;
+            FParse::Value(*Line, TEXT("Runs="), Runs);
+            Config.Latency = FMath::Max(Config.Latency, 1);
+
+            int32 Failures = 0;
+            for (int32 Run = 0; Run < Runs; ++Run) {
+                const FDaxSoakResult Result = RunSoak(Config);
+                if (!Result.IsConverged()) {
+                    ++Failures;
+                    UE_LOGFMT(DataXSystem, Error, "DaxNetSoak: seed {0} did not converge (settled={1}, server nodes={2}, client nodes={3})\nServer: {4}\nClient: {5}",
+                              Config.Seed, Result.bSettled, Result.ServerNodes, Result.ClientNodes, Result.ServerText, Result.ClientText);
+                }
+                ++Config.Seed;
+            }
+            UE_LOGFMT(DataXSystem, Display, "DaxNetSoak: {0}/{1} runs converged", Runs - Failures, Runs);
+        }));
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDaxNetSoakTest, "DaxSystem.Net.Soak",
+                                 EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::EngineFilter)
+
+bool FDaxNetSoakTest::RunTest(const FString& Parameters) {
+    struct FSoakCase {
+        const TCHAR* Name;
+        float Loss;
+        float Reorder;
+        float AckLoss;
+        int32 Latency;
+    };
+    const FSoakCase Cases[] = {
+        {TEXT("Lossy"), 0.1f, 0.05f, 0.f, 3},
+        // 回执丢失: 已送达的包被当作丢包, 基线退回后客户端收到建立在更旧基线上的重复修改
+        {TEXT("DuplicateBase"), 0.f, 0.f, 0.25f, 3},
+        // 乱序: 基于新基线的包被丢弃, 基于退回基线的包后到, 初始包也可能丢失重发
+        {TEXT("OutOfOrderBase"), 0.05f, 0.3f, 0.1f, 4},
+        // 高延迟丢包: 包 N 丢失后, 建立在 N 之上的 N+1.. 在丢包回执让基线退回之前送达, 数组编辑脚本的基线与客户端不一致
+        {TEXT("LossBeforeNak"), 0.25f, 0.f, 0.f, 8},
+    };
+    for (const FSoakCase& Case : Cases) {
+        for (int32 Seed = 1; Seed <= 4; ++Seed) {
+            FDaxSoakConfig Config;
+            Config.Frames = 300;
+            Config.Seed = Seed;
+            Config.Loss = Case.Loss;
+            Config.Reorder = Case.Reorder;
+            Config.AckLoss = Case.AckLoss;
+            Config.Latency = Case.Latency;
+            const FDaxSoakResult Result = RunSoak(Config);
+            const FString What = FString::Printf(TEXT("%s seed %d"), Case.Name, Seed);
+            TestFalse(*(What + TEXT(": client read failed")), Result.bReadFailed);
+            TestTrue(*(What + TEXT(": replication settled")), Result.bSettled);
+            TestEqual(*(What + TEXT(": node count")), static_cast<int32>(Result.ClientNodes), static_cast<int32>(Result.ServerNodes));
+            TestEqual(*(What + TEXT(": container contents")), Result.ClientText, Result.ServerText);
+        }
+    }
+    return true;
+}
+
+#endif
+
+#endif
@@ -164,35 +164,59 @@ namespace ArzDax {
 
         bool Identical(const FDaxNode* Other, uint32 PortFlags) const;
 
+        // 读取时类型一致则直接反序列化进现有的 Small/Heap 存储, 不经过临时对象; 类型不同才重建存储
         bool SerializeValueData(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type) {
             if (Ar.IsLoading()) {
-                ResetToEmpty();
-                auto Temp = FInstancedStruct();
-                Temp.InitializeAs(Type);
-                if (Type->GetCppStructOps()->HasNetSerializer()) {
-                    bool Success = true;
-                    Type->GetCppStructOps()->NetSerialize(Ar, Map, Success, Temp.GetMutableMemory());
-                }
-                else {
-                    Type->SerializeBin(Ar, Temp.GetMutableMemory());
+                if (!Type) return false;
+                FStructView Current = TryGetValueGenericMutable();
+                if (Current.GetScriptStruct() != Type) {
+                    if (FDaxSmallValue::CanInline(Type)) Value.Emplace<FDaxSmallValue>(Type);
+                    else Value.Emplace<FDaxHeapValue>(Type);
+                    Current = TryGetValueGenericMutable();
                 }
-                TrySetValue(Temp);
+                SerializeValueMemory(Ar, Map, Type, Current.GetMemory());
             }
             else if (Ar.IsSaving()) {
                 if (!IsValue()) return false;
                 auto SV = TryGetValueGenericMutable();
-                auto SS = SV.GetScriptStruct();
-                if (SS != Type) return false;
-                if (SS->GetCppStructOps()->HasNetSerializer()) {
-                    bool Success = true;
-                    SS->GetCppStructOps()->NetSerialize(Ar, Map, Success, SV.GetMemory());
-                }
-                else {
-                    SS->SerializeBin(Ar, SV.GetMemory());
-                }
+                if (SV.GetScriptStruct() != Type) return false;
+                SerializeValueMemory(Ar, Map, Type, SV.GetMemory());
             }
 
             return true;
         }
+
+        static void SerializeValueMemory(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, void* Memory) {
+            const UScriptStruct::ICppStructOps* Ops = Type->GetCppStructOps();
+            if (Ops && Ops->HasNetSerializer()) {
+                bool Success = true;
+                Ops->NetSerialize(Ar, Map, Success, Memory);
+            }
+            else {
+                Type->SerializeBin(Ar, Memory);
+            }
+        }
+
+        // 本地没有对应节点时只消费比特流: 小结构放在栈上, 不产生堆分配
+        template <typename Func>
+        static void WithScratchValue(const UScriptStruct* Type, Func&& Function) {
+            static constexpr int32 MaxStackScratch = 1024;
+            if (Type->GetStructureSize() <= MaxStackScratch) {
+                void* Scratch = FMemory_Alloca_Aligned(Type->GetStructureSize(), Type->GetMinAlignment());
+                Type->InitializeStruct(Scratch);
+                Function(Scratch);
+                Type->DestroyStruct(Scratch);
+            }
+            else {
+                FInstancedStruct Temp;
+                Temp.InitializeAs(Type);
+                Function(Temp.GetMutableMemory());
+            }
+        }
+
+        static void SkipValueData(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type) {
+            if (!Type) return;
+            WithScratchValue(Type, [&](void* Memory) { SerializeValueMemory(Ar, Map, Type, Memory); });
+        }
     };
 }
\ No newline at end of file
@@ -19,3 +19,45 @@ FArchive& operator<<(FArchive& Ar, FDaxNodeID& ID) {
     }
     return Ar;
 }
+
+namespace {
+    // 非递增的情况按 ZigZag 编码, 不要求列表严格有序
+    FORCEINLINE uint32 ZigZag(const int32 Value) { return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31); }
+
+    FORCEINLINE int32 UnZigZag(const uint32 Value) { return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1); }
+}
+
+void ArzDax::FDaxNodeIDListCodec::Write(FArchive& Ar, const FDaxNodeID ID) {
+    uint32 Gap = ZigZag(static_cast<int32>(ID.Index) - PrevIndex - 1);
+    Ar.SerializeIntPacked(Gap);
+    uint8 bSameGeneration = static_cast<int32>(ID.Generation) == PrevGeneration ? 1 : 0;
+    Ar.SerializeBits(&bSameGeneration, 1);
+    if (!bSameGeneration) {
+        uint32 GenerationDelta = ZigZag(static_cast<int32>(ID.Generation) - PrevGeneration);
+        Ar.SerializeIntPacked(GenerationDelta);
+    }
+    PrevIndex = ID.Index;
+    PrevGeneration = ID.Generation;
+}
+
+void ArzDax::FDaxNodeIDListCodec::Read(FArchive& Ar, FDaxNodeID& OutID) {
+    uint32 Gap = 0;
+    Ar.SerializeIntPacked(Gap);
+    const int32 Index = PrevIndex + 1 + UnZigZag(Gap);
+    uint8 bSameGeneration = 0;
+    Ar.SerializeBits(&bSameGeneration, 1);
+    int32 Generation = PrevGeneration;
+    if (!bSameGeneration) {
+        uint32 GenerationDelta = 0;
+        Ar.SerializeIntPacked(GenerationDelta);
+        Generation += UnZigZag(GenerationDelta);
+    }
+    if (Index < 0 || Index > MAX_uint16 || Generation < 0 || Generation > MAX_uint16) {
+        Ar.SetError();
+        OutID = FDaxNodeID();
+        return;
+    }
+    OutID = FDaxNodeID(static_cast<uint16>(Index), static_cast<uint16>(Generation));
+    PrevIndex = Index;
+    PrevGeneration = Generation;
+}
@@ -61,4 +61,15 @@ namespace ArzDax {
             return A == B;
         }
     };
-}
\ No newline at end of file
+
+    // 有序 ID 列表的流式编码: 下标写成与上一个 ID 的间隔, 代数与上一个相同时只占 1bit.
+    // 写入方与读取方各持有一份, 每个列表开头重新构造
+    struct FDaxNodeIDListCodec {
+        int32 PrevIndex = -1;
+        int32 PrevGeneration = 0;
+
+        void Write(FArchive& Ar, FDaxNodeID ID);
+
+        void Read(FArchive& Ar, FDaxNodeID& OutID);
+    };
+}
@@ -0,0 +1,98 @@
+﻿#include "DaxSystem/Private/DaxPropertyDelta.h"
+#include "Serialization/StructuredArchive.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/UnrealType.h"
+
+using namespace ArzDax;
+
+namespace {
+    // 用 TObjectKey 而不是裸指针: 蓝图结构体被回收后地址可能被新类型复用, 不能让新类型继承开关
+    TSet<TObjectKey<UScriptStruct>>& GetEnabledTypes() {
+        static TSet<TObjectKey<UScriptStruct>> EnabledTypes;
+        return EnabledTypes;
+    }
+
+    int32 GetSlotCount(const UScriptStruct* Type) {
+        int32 Count = 0;
+        for (TFieldIterator<FProperty> It(Type); It; ++It) Count += It->ArrayDim;
+        return Count;
+    }
+
+    // 容器属性和非原生网络序列化的结构体属性不支持 NetSerializeItem, 走与 SerializeBin 相同的二进制路径
+    void SerializeSlot(FArchive& Ar, UPackageMap* Map, const FProperty* Property, void* ValuePtr) {
+        bool bUseBinary = Property->IsA<FArrayProperty>() || Property->IsA<FMapProperty>() || Property->IsA<FSetProperty>();
+        if (const FStructProperty* StructProperty = CastField<FStructProperty>(Property)) {
+            bUseBinary = (StructProperty->Struct->StructFlags & STRUCT_NetSerializeNative) == 0;
+        }
+        if (bUseBinary) {
+            FStructuredArchiveFromArchive Adapter(Ar);
+            Property->SerializeItem(Adapter.GetSlot(), ValuePtr, nullptr);
+        }
+        else {
+            Property->NetSerializeItem(Ar, Map, ValuePtr);
+        }
+    }
+}
+
+void FDaxPropertyDelta::SetEnabled(const UScriptStruct* Type, const bool bEnabled) {
+    if (!Type) return;
+    if (bEnabled) GetEnabledTypes().Add(Type);
+    else GetEnabledTypes().Remove(Type);
+}
+
+bool FDaxPropertyDelta::IsEnabled(const UScriptStruct* Type) {
+    if (!Type || !GetEnabledTypes().Contains(Type)) return false;
+    const UScriptStruct::ICppStructOps* Ops = Type->GetCppStructOps();
+    return !(Ops && Ops->HasNetSerializer());
+}
+
+bool FDaxPropertyDelta::BuildChangedMask(const UScriptStruct* Type, const void* OldMemory, const void* NewMemory, TBitArray<>& OutMask) {
+    if (!Type || !OldMemory || !NewMemory) return false;
+    OutMask.Init(false, GetSlotCount(Type));
+    int32 Slot = 0;
+    int32 ChangedCount = 0;
+    for (TFieldIterator<FProperty> It(Type); It; ++It) {
+        const FProperty* Property = *It;
+        for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex, ++Slot) {
+            const void* OldValue = Property->ContainerPtrToValuePtr<void>(OldMemory, ArrayIndex);
+            const void* NewValue = Property->ContainerPtrToValuePtr<void>(NewMemory, ArrayIndex);
+            if (!Property->Identical(OldValue, NewValue, PPF_None)) {
+                OutMask[Slot] = true;
+                ++ChangedCount;
+            }
+        }
+    }
+    return ChangedCount < OutMask.Num();
+}
+
+void FDaxPropertyDelta::Write(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, void* Memory, const TBitArray<>& Mask) {
+    for (int32 Slot = 0; Slot < Mask.Num(); ++Slot) {
+        uint8 bChanged = Mask[Slot] ? 1 : 0;
+        Ar.SerializeBits(&bChanged, 1);
+    }
+    int32 Slot = 0;
+    for (TFieldIterator<FProperty> It(Type); It; ++It) {
+        const FProperty* Property = *It;
+        for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex, ++Slot) {
+            if (!Mask[Slot]) continue;
+            SerializeSlot(Ar, Map, Property, Property->ContainerPtrToValuePtr<void>(Memory, ArrayIndex));
+        }
+    }
+}
+
+void FDaxPropertyDelta::Read(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, void* Memory) {
+    TBitArray<> Mask(false, GetSlotCount(Type));
+    for (int32 Slot = 0; Slot < Mask.Num(); ++Slot) {
+        uint8 bChanged = 0;
+        Ar.SerializeBits(&bChanged, 1);
+        Mask[Slot] = bChanged != 0;
+    }
+    int32 Slot = 0;
+    for (TFieldIterator<FProperty> It(Type); It; ++It) {
+        const FProperty* Property = *It;
+        for (int32 ArrayIndex = 0; ArrayIndex < Property->ArrayDim; ++ArrayIndex, ++Slot) {
+            if (!Mask[Slot]) continue;
+            SerializeSlot(Ar, Map, Property, Property->ContainerPtrToValuePtr<void>(Memory, ArrayIndex));
+        }
+    }
+}
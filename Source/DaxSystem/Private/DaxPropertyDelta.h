@@ -0,0 +1,24 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+class UPackageMap;
+
+namespace ArzDax {
+
+    // 值节点的属性级增量: 只对显式开启的 UScriptStruct 生效.
+    // 线上格式: 每个属性槽位(属性 x ArrayDim)一个变化位, 随后依次是变化槽位的数据.
+    struct FDaxPropertyDelta {
+        // 开启/关闭某个类型的属性级增量, 自带 NetSerializer 的类型会被忽略(保留其自定义量化)
+        static void SetEnabled(const UScriptStruct* Type, bool bEnabled);
+
+        static bool IsEnabled(const UScriptStruct* Type);
+
+        // 比较两份同类型的内存, 只有部分槽位变化时返回 true; 全部变化时整体发送更省
+        static bool BuildChangedMask(const UScriptStruct* Type, const void* OldMemory, const void* NewMemory, TBitArray<>& OutMask);
+
+        static void Write(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, void* Memory, const TBitArray<>& Mask);
+
+        static void Read(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, void* Memory);
+    };
+}
@@ -1,14 +1,167 @@
 ﻿#include "DaxSystem/Private/DaxSet.h"
 #include "DaxSystem/Private/DaxNode.h"
+#include "DaxSystem/Private/DaxPropertyDelta.h"
+#include "DaxSystem/Private/DaxArrayDiff.h"
+#include "DaxSystem/Private/DaxNetDictionary.h"
+#include "DaxSystem/Private/DaxWriteBatch.h"
+#include "DaxSystem/Public/DaxBuiltinTypes.h"
+#include "DaxSystem/Public/DaxComponent.h"
+#include "Engine/NetConnection.h"
+#include "Engine/PackageMapClient.h"
+#include "GameFramework/Actor.h"
+#include "Algo/Reverse.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Compression.h"
+#include "Misc/ScopeExit.h"
+#include "UObject/CoreNet.h"
+#include "UObject/ObjectKey.h"
 
 using namespace ArzDax;
 
+static TAutoConsoleVariable<int32> CVarDaxNetChangeLogCapacity(
+    TEXT("dax.Net.ChangeLogCapacity"),
+    1024,
+    TEXT("Number of change entries each DaxSet keeps for changelog-driven delta replication. Connections older than the log fall back to chunk diffing."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDaxNetHydrationBudgetBytes(
+    TEXT("dax.Net.HydrationBudgetBytes"),
+    16384,
+    TEXT("Per-connection byte budget for newly added nodes in one replication update. Nodes over the budget are deferred to later updates, ")
+    TEXT("and a joining client hydrates through the same path. 0 disables the budget and sends the initial state as one full sync. ")
+    TEXT("The budget counts bytes before compression; see dax.Net.FullSyncCompressNodes."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDaxNetReplayCheckpoint(
+    TEXT("dax.Net.ReplayCheckpoint"),
+    1,
+    TEXT("Write full syncs on replay connections in the compact checkpoint format. Types and map keys are written once per checkpoint, ")
+    TEXT("and playback applies a checkpoint as a diff against the current container so scrubbing only touches changed nodes."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDaxNetMaxStagedPackets(
+    TEXT("dax.Net.MaxStagedPackets"),
+    64,
+    TEXT("Number of packets a client queues behind a read that is waiting for an unmapped value type before a warning is logged. ")
+    TEXT("Staged packets are never dropped: the server treats them as delivered and would not resend their contents."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDaxNetFullSyncCompressNodes(
+    TEXT("dax.Net.FullSyncCompressNodes"),
+    512,
+    TEXT("Full syncs and hydration batches of sets with at least this many nodes compress their body with Oodle. ")
+    TEXT("The raw body is sent when compression does not pay off. 0 disables compression."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarDaxNetPredictionTimeout(
+    TEXT("dax.Net.PredictionTimeout"),
+    2.0f,
+    TEXT("Seconds a client-side predicted value is kept while the server has not touched its node. Expired predictions fall back to the authoritative value. 0 keeps them until the server touches the node."),
+    ECVF_Default);
+
+namespace {
+    enum : uint32 {
+        CheckpointKindEmpty = 0,
+        CheckpointKindArray = 1,
+        CheckpointKindMap = 2,
+        CheckpointKindValue = 3,
+    };
+
+    constexpr uint32 MaxFullSyncBodyBytes = 64 * 1024 * 1024;
+
+    // 压缩后的全量正文: 原始比特数 + 压缩字节数 + 压缩数据; 没有变小时返回 false, 调用方改发原始比特
+    bool WriteCompressedBody(FBitWriter& Writer, FBitWriter& Body) {
+        const int32 RawBytes = static_cast<int32>(Body.GetNumBytes());
+        int32 CompressedBytes = FCompression::CompressMemoryBound(NAME_Oodle, RawBytes);
+        TArray<uint8> Compressed;
+        Compressed.SetNumUninitialized(CompressedBytes);
+        if (!FCompression::CompressMemory(NAME_Oodle, Compressed.GetData(), CompressedBytes, Body.GetData(), RawBytes) || CompressedBytes >= RawBytes) {
+            return false;
+        }
+        uint32 RawBits = static_cast<uint32>(Body.GetNumBits());
+        uint32 Size = static_cast<uint32>(CompressedBytes);
+        Writer.SerializeIntPacked(RawBits);
+        Writer.SerializeIntPacked(Size);
+        Writer.Serialize(Compressed.GetData(), CompressedBytes);
+        return true;
+    }
+
+    bool ReadCompressedBody(FBitReader& Reader, TArray<uint8>& OutBody, int64& OutBodyBits) {
+        uint32 RawBits = 0;
+        uint32 Size = 0;
+        Reader.SerializeIntPacked(RawBits);
+        Reader.SerializeIntPacked(Size);
+        const uint32 RawBytes = (RawBits + 7) >> 3;
+        if (Reader.IsError() || RawBytes > MaxFullSyncBodyBytes || Size > static_cast<uint32>(Reader.GetBytesLeft())) {
+            Reader.SetError();
+            return false;
+        }
+        TArray<uint8> Compressed;
+        Compressed.SetNumUninitialized(Size);
+        Reader.Serialize(Compressed.GetData(), Size);
+        OutBody.SetNumUninitialized(RawBytes);
+        if (Reader.IsError() || !FCompression::UncompressMemory(NAME_Oodle, OutBody.GetData(), RawBytes, Compressed.GetData(), Size)) {
+            UE_LOGFMT(DataXSystem, Error, "DaxSet: failed to decompress a full sync body ({0} -> {1} bytes)", Size, RawBytes);
+            Reader.SetError();
+            return false;
+        }
+        OutBodyBits = RawBits;
+        return true;
+    }
+
+    // 网络字典的确认窗口: 当前正在填充的包序号与已确认的最大包序号; 没有连接或内部确认(回放)时视为立即确认
+    void GetNetPacketWindow(const FNetDeltaSerializeInfo& DeltaParms, int32& OutPacketId, int32& OutAckedPacketId) {
+        OutPacketId = 0;
+        OutAckedPacketId = MAX_int32;
+        UPackageMapClient* PackageMap = Cast<UPackageMapClient>(DeltaParms.Map);
+        const UNetConnection* Connection = PackageMap ? PackageMap->GetConnection() : nullptr;
+        if (!Connection || DeltaParms.bInternalAck) return;
+        OutPacketId = Connection->OutPacketId;
+        OutAckedPacketId = Connection->OutAckPacketId;
+    }
+
+    // Iris 路径没有 PackageMap: 含对象引用的类型无法同步, 自定义 NetSerialize 也可能解引用空的 Map.
+    // 本模块的内置类型不使用 Map; 其余类型只要满足其一就按空节点量化, 每个类型只报一次错
+    bool IsIrisSerializableType(const UScriptStruct* Type) {
+        static TMap<TObjectKey<UScriptStruct>, bool> Cache;
+        if (const bool* Found = Cache.Find(Type)) return *Found;
+        bool bSerializable = true;
+        const UScriptStruct::ICppStructOps* Ops = Type->GetCppStructOps();
+        if (Ops && Ops->HasNetSerializer() && Type->GetOutermost() != FDaxBuiltinBool::StaticStruct()->GetOutermost()) bSerializable = false;
+        TArray<const FStructProperty*> EncounteredStructProps;
+        for (TFieldIterator<FProperty> It(Type); It && bSerializable; ++It) {
+            if (It->ContainsObjectReference(EncounteredStructProps, EPropertyObjectReferenceType::Strong | EPropertyObjectReferenceType::Weak)) bSerializable = false;
+        }
+        if (!bSerializable) {
+            UE_LOGFMT(DataXSystem, Error, "DaxSet: value type {0} holds object references or a custom NetSerialize and cannot replicate through Iris; its values are sent as empty nodes",
+                      Type->GetPathName());
+        }
+        Cache.Add(Type, bSerializable);
+        return bSerializable;
+    }
+
+    // 预测只会写值或清空, 容器节点不参与比较
+    bool IsPredictionMatched(const ArzDax::FDaxNode& Predicted, const ArzDax::FDaxNode* Authority) {
+        if (!Authority) return false;
+        if (Predicted.IsEmpty()) return Authority->IsEmpty();
+        const FConstStructView PredictedView = Predicted.TryGetValueGeneric();
+        const FConstStructView AuthorityView = Authority->TryGetValueGeneric();
+        const UScriptStruct* Type = PredictedView.GetScriptStruct();
+        if (!Type || Type != AuthorityView.GetScriptStruct()) return false;
+        return Type->CompareScriptStruct(PredictedView.GetMemory(), AuthorityView.GetMemory(), PPF_None);
+    }
+}
+
 FDaxSet::FDaxSet() {
     LiveToken = MakeShared<uint8>(0);
     RootID = Allocator.Allocate();
     BumpNodeDataVersionAndStruct(RootID);
 }
 
+FDaxSet::~FDaxSet() {
+    ReleaseOldValues();
+}
+
 FDaxSet::FDaxSet(const FDaxSet& Other) {
     LiveToken = MakeShared<uint8>(0);
     CopySet(Other);
@@ -318,6 +471,7 @@ void FDaxSet::CopySet(const FDaxSet& Other) {
     if (&Other == this) return;
     if (!Other.RootID.IsValid()) return;
     Allocator.Reset();
+    ChangeLog.Invalidate(DataVersion);
     RootID = DeepCopyNode(const_cast<FDaxSet&>(Other), Other.RootID);
 }
 
@@ -580,6 +734,7 @@ bool FDaxSet::RedirectNode(const FDaxNodeID Old, const FDaxNodeID New) {
 
 bool FDaxSet::ReleaseNode(const FDaxNodeID ID) {
     if (!Allocator.IsNodeValid(ID)) return false;
+    RecordChange(ID);
     return Allocator.Deallocate(ID);
 }
 
@@ -645,6 +800,8 @@ void FDaxSet::ReleaseSubtreeImp(const FDaxNodeID ID, uint32& ClearNum) {
         }
     }
 
+    RecordChange(ID);
+    MarkFrameChanged(ID, EDaxChangeKind::Removed);
     if (Allocator.Deallocate(ID)) {
         ++ClearNum;
     }
@@ -674,11 +831,12 @@ void FDaxSet::GetNodeNumRecursiveImp(const FDaxNodeID ID, int32& ClearNum) const
 
 void FDaxSet::Clear() {
     Allocator.Reset();
+    ChangeLog.Invalidate(DataVersion);
     RootID = {};
 }
 
 bool FDaxSet::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
-    if (DeltaParms.bUpdateUnmappedObjects) return true;
+    if (DeltaParms.bUpdateUnmappedObjects) return Sync_ClientResumeRead(DeltaParms);
     SCOPE_CYCLE_COUNTER(STAT_NetSyncTick);
 
     // Sync: 新实现入口
@@ -687,389 +845,1477 @@ bool FDaxSet::NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms) {
         if (GetNodeNum() <= 1) return false;
         if (DataVersion == 0 && StructVersion == 0) return false; // 空容器无需同步
 
-        FDaxSetBaseState* OldState = static_cast<FDaxSetBaseState*>(DeltaParms.OldState);
-        if (OldState == nullptr) {
-            TSharedPtr<FDaxSetBaseState> NewState = MakeShared<FDaxSetBaseState>();
-            *DeltaParms.NewState = NewState;
-            NewState->ContainerVersion = DataVersion;
-            for (uint32 ci = 0; ci < Allocator.GetChunkCount(); ++ci) {
-                const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(ci);
-                if (!Meta) continue;
-                auto Copy = MakeUnique<FDaxNodeChunkMeta>(*Meta);
-                NewState->ChildStates.Add(MoveTemp(Copy));
-            }
-
-            Allocator.ForEachNode([&](const FDaxNodeID NodeID, FDaxNode& Node, const uint32 Version, const FDaxNodeID Parent, const UScriptStruct* Type) {
-                if (Type == FDaxFakeTypeArray::StaticStruct()) {
-                    if (auto* Arr = Node.GetArray()) { NewState->ArrayMirror[NodeID] = *Arr; }
-                }
-                else if (Type == FDaxFakeTypeMap::StaticStruct()) {
-                    if (auto* Map = Node.GetMap()) { NewState->MapMirror[NodeID] = *Map; }
-                }
-            });
+        // 本次序列化之前的所有修改折叠进一个新的块 Epoch, 同一帧内的多个连接共享这个 Epoch
+        Allocator.FlushDirtyChunks();
 
-            return Sync_ServerFullWrite(DeltaParms);
+        // 确认是服务端写出之后才启用变更日志; 启用之前的修改不在日志内, 由 Invalidate 把这些连接排除到回退路径
+        ChangeLog.SetCapacity(CVarDaxNetChangeLogCapacity.GetValueOnAnyThread(), DataVersion);
+
+        FDaxSetBaseState* OldState = static_cast<FDaxSetBaseState*>(DeltaParms.OldState);
+        if (OldState == nullptr || !OldState->Snapshot.IsValid()) {
+            // 回放连接没有往返确认, 检查点和录制起点一次写完, 不走分帧水合
+            if (DeltaParms.bInternalAck && CVarDaxNetReplayCheckpoint.GetValueOnAnyThread() != 0) return Sync_ServerCheckpointWrite(DeltaParms);
+            if (CVarDaxNetHydrationBudgetBytes.GetValueOnAnyThread() > 0) {
+                // 分帧水合: 以空快照为基线走增量路径, 每帧只发送预算内的新增节点
+                FDaxSetBaseState EmptyState{};
+                EmptyState.Snapshot = MakeShared<const FDaxSetSnapshot>();
+                return Sync_ServerDeltaWrite(DeltaParms, &EmptyState, true);
+            }
+            return Sync_ServerFullWrite(DeltaParms); // NewState 与镜像在全量写入中一并生成
         }
         else {
-            if (OldState->ContainerVersion == DataVersion) return false;
+            if (OldState->ContainerVersion == DataVersion && OldState->PendingNodes == 0 && OldState->NetConditionSerial == NetConditionSerial &&
+                OldState->bOwnerConnection == IsNetOwnerConnection(DeltaParms.Map)) {
+                // 只剩限频延后的更新时, 间隔未到就不写
+                if (OldState->StaleNodes.IsEmpty() || FPlatformTime::Seconds() < OldState->NextStaleSendTime) return false;
+            }
             return Sync_ServerDeltaWrite(DeltaParms, OldState);
         }
     }
 
     if (DeltaParms.Reader) {
         bRunningOnServer = false;
-        OldValueMap.clear();
-        FBitReader& Reader = *DeltaParms.Reader;
-        const bool IsFullSync = Reader.ReadBit() != 0;
-        if (IsFullSync) return Sync_ClientFullRead(DeltaParms);
-        return Sync_ClientDeltaRead(DeltaParms);
+        if (PendingNetRead.IsValid()) {
+            // 前面还有中断的包, 新包整包排队, 再尝试一次续读
+            FBitReader& Reader = *DeltaParms.Reader;
+            FDaxStagedNetPacket& Packet = PendingNetRead->Queued.AddDefaulted_GetRef();
+            Packet.NumBits = Reader.GetNumBits() - Reader.GetPosBits();
+            Packet.Data.SetNumZeroed(static_cast<int32>((Packet.NumBits + 7) >> 3));
+            appBitsCpy(Packet.Data.GetData(), 0, Reader.GetData(), static_cast<int32>(Reader.GetPosBits()), static_cast<int32>(Packet.NumBits));
+            return Sync_ClientResumeRead(DeltaParms);
+        }
+        return Sync_ClientRead(DeltaParms);
     }
 
     return false;
 }
 
-// ================== 监听/OldValue API实现 ==================
+bool FDaxSet::Sync_ClientRead(FNetDeltaSerializeInfo& DeltaParms) {
+    PrepareOldValueCapture();
+    FBitReader& Reader = *DeltaParms.Reader;
+    // 解压后的正文换成独立的 Reader, 未映射类型的暂存同样作用在正文上
+    auto ReadCompressed = [&](TFunctionRef<bool()> ReadBody) {
+        TArray<uint8> Body;
+        int64 BodyBits = 0;
+        if (!ReadCompressedBody(Reader, Body, BodyBits)) return false;
+        FNetBitReader BodyReader(DeltaParms.Map, Body.GetData(), BodyBits);
+        FBitReader* const OuterReader = DeltaParms.Reader;
+        DeltaParms.Reader = &BodyReader;
+        const bool bSuccess = ReadBody();
+        DeltaParms.Reader = OuterReader;
+        return bSuccess;
+    };
+    const bool IsFullSync = Reader.ReadBit() != 0;
+    if (IsFullSync) {
+        const bool bBeginHydration = Reader.ReadBit() != 0;
+        if (!bBeginHydration) {
+            const bool bCheckpoint = Reader.ReadBit() != 0;
+            if (bCheckpoint) return Sync_ClientCheckpointRead(DeltaParms);
+            const bool bCompressed = Reader.ReadBit() != 0;
+            if (!bCompressed) return Sync_ClientFullRead(DeltaParms);
+            return ReadCompressed([&] { return Sync_ClientFullRead(DeltaParms); });
+        }
+        Allocator.Reset();
+        ReconcilePredictions(nullptr); // 权威状态整体重建, 所有预测按移除结算
+        RootID = {};
+        ClientTypeTable.Reset();
+        ClientKeyTable.Reset();
+        bClientHydrating = true;
+    }
+    const bool bCompressed = Reader.ReadBit() != 0; // 水合批次可能整体压缩
+    if (!bCompressed) return Sync_ClientDeltaRead(DeltaParms);
+    return ReadCompressed([&] { return Sync_ClientDeltaRead(DeltaParms); });
+}
 
-bool FDaxSet::BindOnChanged(const FDaxVisitor& Position, int32 Depth, const FDaxOnChangedDynamic& Delegate) {
-    //if (bRunningOnServer) return false; // 仅客户端
-    if (!Position.IsValid()) return false;
-    if (!Delegate.IsBound()) return false;
-    FDaxOnChangedBinding B {};
-    B.ListenPath = Position;
-    B.Depth = FMath::Max(0, Depth);
-    B.Delegate = Delegate;
-    OnChangedBindings.Add(B);
-    return true;
+void FDaxSet::StagePendingNetRead(FBitReader& Reader, const int64 RecordStartBits, FDaxNetReadCursor&& Cursor) {
+    PendingNetRead = MakeUnique<FDaxPendingNetRead>();
+    PendingNetRead->Cursor = MoveTemp(Cursor);
+    FDaxStagedNetPacket& Remaining = PendingNetRead->Remaining;
+    Remaining.NumBits = Reader.GetNumBits() - RecordStartBits;
+    Remaining.Data.SetNumZeroed(static_cast<int32>((Remaining.NumBits + 7) >> 3));
+    appBitsCpy(Remaining.Data.GetData(), 0, Reader.GetData(), static_cast<int32>(RecordStartBits), static_cast<int32>(Remaining.NumBits));
 }
 
-void FDaxSet::UnbindOnChanged(const FDaxVisitor& Position) {
-    OnChangedBindings.RemoveAll([&](const FDaxOnChangedBinding& B) {
-        return B.ListenPath == Position;
-    });
+bool FDaxSet::Sync_ClientResumeRead(FNetDeltaSerializeInfo& DeltaParms) {
+    if (!PendingNetRead.IsValid()) return true;
+    SCOPE_CYCLE_COUNTER(STAT_NetSyncTick);
+    bRunningOnServer = false;
+
+    PrepareOldValueCapture();
+    TUniquePtr<FDaxPendingNetRead> Pending = MoveTemp(PendingNetRead);
+    FBitReader* const OuterReader = DeltaParms.Reader;
+    bool bSuccess = true;
+    {
+        FNetBitReader Reader(DeltaParms.Map, Pending->Remaining.Data.GetData(), Pending->Remaining.NumBits);
+        DeltaParms.Reader = &Reader;
+        switch (Pending->Cursor.Kind) {
+            case EDaxNetReadKind::Full: bSuccess = Sync_ClientFullRead(DeltaParms, &Pending->Cursor); break;
+            case EDaxNetReadKind::Delta: bSuccess = Sync_ClientDeltaRead(DeltaParms, &Pending->Cursor); break;
+            case EDaxNetReadKind::Checkpoint: bSuccess = Sync_ClientCheckpointRead(DeltaParms); break;
+        }
+    }
+
+    // 暂存数据读完后按到达顺序重放排队的包, 再次中断时剩余的包挂到新的暂存之后
+    int32 QueuedIndex = 0;
+    while (bSuccess && !PendingNetRead.IsValid() && QueuedIndex < Pending->Queued.Num()) {
+        FDaxStagedNetPacket& Packet = Pending->Queued[QueuedIndex++];
+        FNetBitReader Reader(DeltaParms.Map, Packet.Data.GetData(), Packet.NumBits);
+        DeltaParms.Reader = &Reader;
+        bSuccess = Sync_ClientRead(DeltaParms);
+    }
+    DeltaParms.Reader = OuterReader;
+
+    if (!bSuccess) {
+        UE_LOGFMT(DataXSystem, Error, "DaxSet: resumed read failed, dropping {0} staged packets", Pending->Queued.Num() - QueuedIndex + 1);
+        PendingNetRead.Reset();
+        return false;
+    }
+    if (PendingNetRead.IsValid()) {
+        for (; QueuedIndex < Pending->Queued.Num(); ++QueuedIndex) PendingNetRead->Queued.Add(MoveTemp(Pending->Queued[QueuedIndex]));
+        // 服务端已按送达处理这些包, 丢弃后不会再重发, 只能继续排队等待类型映射; 超过阈值时提示一次
+        PendingNetRead->bOverflowWarned = Pending->bOverflowWarned;
+        if (!PendingNetRead->bOverflowWarned && PendingNetRead->Queued.Num() > CVarDaxNetMaxStagedPackets.GetValueOnAnyThread()) {
+            UE_LOGFMT(DataXSystem, Warning, "DaxSet: {0} packets staged behind an unmapped type, still waiting for it to load", PendingNetRead->Queued.Num());
+            PendingNetRead->bOverflowWarned = true;
+        }
+    }
+    DeltaParms.bOutHasMoreUnmapped = PendingNetRead.IsValid();
+    if (!PendingNetRead.IsValid()) DeltaParms.bOutSomeObjectsWereMapped = true;
+    return true;
 }
 
-void FDaxSet::UnbindAllFor(UObject* TargetObject) {
-    if (!TargetObject) return;
-    OnChangedBindings.RemoveAll([&](const FDaxOnChangedBinding& B) {
-        return B.Delegate.IsBound() && B.Delegate.GetUObject() == TargetObject;
-    });
+// ================== 监听/OldValue API实现 ==================
+
+bool FDaxSet::AddOnChangedBinding(const FDaxVisitor& Position, const int32 Depth, FDaxOnChangedBinding&& Binding) {
+    if (!Position.IsValid() || !Binding.IsValid()) return false;
+    Binding.ListenPath = Position;
+    Binding.Depth = FMath::Max(0, Depth);
+    // 派发期间绑定表不能移动, 新增的监听在派发结束后加入
+    if (bDispatchingOnChanged) DeferredOnChangedBindings.Add(MoveTemp(Binding));
+    else OnChangedBindings.Add(MoveTemp(Binding));
+    bOnChangedIndexDirty = true;
+    return true;
 }
 
-FConstStructView FDaxSet::TryGetOldValueByNodeID(const FDaxNodeID NodeID) const {
-    if (const auto Found = OldValueMap.findPtr(NodeID)) {
-        return FConstStructView(*Found);
+void FDaxSet::RemoveOnChangedBindings(TFunctionRef<bool(const FDaxOnChangedBinding&)> Predicate) {
+    DeferredOnChangedBindings.RemoveAll([&](const FDaxOnChangedBinding& B) { return Predicate(B); });
+    // 还有待派发的回调时按下标引用绑定表, 只做标记, 派发结束后再压缩
+    if (bDispatchingOnChanged || !PendingOnChanged.IsEmpty()) {
+        for (FDaxOnChangedBinding& B : OnChangedBindings) {
+            if (B.bRemoved || !Predicate(B)) continue;
+            B.bRemoved = true;
+            bOnChangedCompactPending = true;
+        }
     }
-    return {};
+    else if (OnChangedBindings.RemoveAll([&](const FDaxOnChangedBinding& B) { return Predicate(B); }) == 0) {
+        return;
+    }
+    bOnChangedIndexDirty = true;
 }
 
-bool FDaxSet::Sync_ServerFullWrite(FNetDeltaSerializeInfo& DeltaParms) {
-    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerFullWrite"));
-    
-    FBitWriter& Writer = *DeltaParms.Writer;
-    TSharedPtr<FDaxSetBaseState> NewState = MakeShared<FDaxSetBaseState>();
-    *DeltaParms.NewState = NewState;
+bool FDaxSet::BindOnChanged(const FDaxVisitor& Position, int32 Depth, const FDaxOnChangedDynamic& Delegate, const bool bCaptureOldValues) {
+    //if (bRunningOnServer) return false; // 仅客户端
+    FDaxOnChangedBinding B {};
+    B.Delegate = Delegate;
+    B.bCaptureOldValues = bCaptureOldValues;
+    return AddOnChangedBinding(Position, Depth, MoveTemp(B));
+}
 
-    Writer.WriteBit(true);
+bool FDaxSet::BindOnChangedAggregate(const FDaxVisitor& Position, int32 Depth, const FDaxOnChangedAggregateDynamic& Delegate, const bool bCaptureOldValues) {
+    FDaxOnChangedBinding B {};
+    B.bAggregate = true;
+    B.AggregateDelegate = Delegate;
+    B.bCaptureOldValues = bCaptureOldValues;
+    return AddOnChangedBinding(Position, Depth, MoveTemp(B));
+}
 
-    NewState->ContainerVersion = DataVersion;
+FDelegateHandle FDaxSet::BindOnChangedNative(const FDaxVisitor& Position, int32 Depth, FDaxOnChangedNative Delegate, const bool bCaptureOldValues) {
+    FDaxOnChangedBinding B {};
+    B.NativeDelegate = MoveTemp(Delegate);
+    B.bCaptureOldValues = bCaptureOldValues;
+    const FDelegateHandle Handle = B.NativeDelegate.GetHandle();
+    return AddOnChangedBinding(Position, Depth, MoveTemp(B)) ? Handle : FDelegateHandle{};
+}
 
-    const uint32 ChunkCount = Allocator.GetChunkCount();
-    for (uint32 ci = 0; ci < ChunkCount; ++ci) {
-        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(ci);
-        if (!Meta) continue;
-        auto Copy = MakeUnique<FDaxNodeChunkMeta>(*Meta);
-        NewState->ChildStates.Add(MoveTemp(Copy));
-    }
+FDelegateHandle FDaxSet::BindOnChangedAggregateNative(const FDaxVisitor& Position, int32 Depth, FDaxOnChangedAggregateNative Delegate, const bool bCaptureOldValues) {
+    FDaxOnChangedBinding B {};
+    B.bAggregate = true;
+    B.NativeAggregateDelegate = MoveTemp(Delegate);
+    B.bCaptureOldValues = bCaptureOldValues;
+    const FDelegateHandle Handle = B.NativeAggregateDelegate.GetHandle();
+    return AddOnChangedBinding(Position, Depth, MoveTemp(B)) ? Handle : FDelegateHandle{};
+}
 
-    uint32 NodeCount = GetNodeNum();
-    Writer.SerializeIntPacked(NodeCount);
+void FDaxSet::UnbindOnChangedNative(const FDelegateHandle Handle) {
+    if (!Handle.IsValid()) return;
+    RemoveOnChangedBindings([Handle](const FDaxOnChangedBinding& B) { return B.GetNativeHandle() == Handle; });
+}
 
-    Allocator.ForEachNode([&](FDaxNodeID NodeID, FDaxNode& Node, uint32 Version, FDaxNodeID Parent,
-                              const UScriptStruct* Type) {
-        Writer << NodeID;
-        Writer << Parent;
-        UObject* TempTypeObject = const_cast<UScriptStruct*>(Type);
-        DeltaParms.Map->SerializeObject(Writer, UScriptStruct::StaticClass(), TempTypeObject);
+void FDaxSet::UnbindOnChanged(const FDaxVisitor& Position) {
+    RemoveOnChangedBindings([&](const FDaxOnChangedBinding& B) { return B.ListenPath == Position; });
+}
 
-        if (Type == nullptr || Type == FDaxFakeTypeEmpty::StaticStruct()) {
-            
-        }
-        else if (Type == FDaxFakeTypeArray::StaticStruct()) {
-            auto* Arr = Node.GetArray();
-            uint32 Count = Arr ? static_cast<uint32>(Arr->Num()) : 0;
-            Writer.SerializeIntPacked(Count);
-            NewState->ArrayMirror[NodeID] = {};
-            auto& ArrRef = NewState->ArrayMirror[NodeID];
-            for (uint32 i = 0; i < Count; ++i) {
-                Writer << (*Arr)[i];
-                ArrRef.Add((*Arr)[i]);
-            }
-        }
-        else if (Type == FDaxFakeTypeMap::StaticStruct()) {
-            auto* Map = Node.GetMap();
-            uint32 Count = Map ? static_cast<uint32>(Map->size()) : 0;
-            Writer.SerializeIntPacked(Count);
-            if (Map) {
-                NewState->MapMirror[NodeID] = {};
-                auto& MapRef = NewState->MapMirror[NodeID];
-                for (auto& Kv : *Map) {
-                    Writer << Kv.first;
-                    Writer << Kv.second;
-                    MapRef[Kv.first] = Kv.second;
-                }
+void FDaxSet::UnbindAllFor(UObject* TargetObject) {
+    if (!TargetObject) return;
+    RemoveOnChangedBindings([TargetObject](const FDaxOnChangedBinding& B) { return B.IsValid() && B.GetTargetObject() == TargetObject; });
+}
+
+void FDaxSet::RebuildOnChangedIndex() {
+    OnChangedAnchorIndex.Reset();
+    OnChangedMaxDepth = 0;
+    OldValueCaptureDepth = INDEX_NONE;
+    for (int32 i = 0; i < OnChangedBindings.Num(); ++i) {
+        FDaxOnChangedBinding& B = OnChangedBindings[i];
+        if (!B.IsValid()) continue;
+        // 锚点每个结构版本只解析一次, 期间节点ID稳定
+        if (B.AnchorStructVersion != StructVersion || !Allocator.IsNodeValid(B.AnchorID)) {
+            // 旧锚点本帧被移除时先记下, 重新解析之后锚点表里已经没有它, 监听仍要收到自身的 Removed
+            const FDaxNodeID PreviousAnchor = B.AnchorID;
+            if (PreviousAnchor.IsValid() && !Allocator.IsNodeValid(PreviousAnchor)) {
+                const auto* Change = FrameChangedNodes.findPtr(PreviousAnchor);
+                if (Change && Change->Kind == EDaxChangeKind::Removed) B.RemovedAnchorID = PreviousAnchor;
             }
+            B.AnchorID = B.ListenPath.HasData() ? B.ListenPath.GetCachedNodeID() : FDaxNodeID{};
+            B.AnchorStructVersion = StructVersion;
         }
-        else {
-            Node.SerializeValueData(Writer, DeltaParms.Map, Type);
-        }
-    });
-    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerFullWrite End"));
-    return true;
+        if (!B.AnchorID.IsValid()) continue; // 监听位置尚不存在, 结构变化后重试
+        OnChangedAnchorIndex.FindOrAdd(B.AnchorID).Add(i);
+        OnChangedMaxDepth = FMath::Max(OnChangedMaxDepth, B.Depth);
+        if (B.bCaptureOldValues) OldValueCaptureDepth = FMath::Max(OldValueCaptureDepth, B.Depth);
+    }
+    OnChangedIndexStructVersion = StructVersion;
+    bOnChangedIndexDirty = false;
 }
 
-bool FDaxSet::Sync_ServerDeltaWrite(FNetDeltaSerializeInfo& DeltaParms, FDaxSetBaseState* OldState) {
-    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerDeltaWrite"));
-    FBitWriter& Writer = *DeltaParms.Writer;
-    Writer.WriteBit(false); // Delta Sync
-
-    const int32 CurrChunkCount = static_cast<int32>(Allocator.GetChunkCount());
-    const int32 OldChunkCount = OldState ? OldState->ChildStates.Num() : 0;
-    const int32 MaxChunkCount = FMath::Max(CurrChunkCount, OldChunkCount);
+void FDaxSet::CollectOnChanged() {
+    // 收集时取走本帧的变更集合; 派发回调和 OnHydrated 中产生的变更记入清空后的集合, 留到下一帧匹配
+    ON_SCOPE_EXIT { FrameChangedNodes.clear(); };
+    if (OnChangedBindings.IsEmpty() || FrameChangedNodes.empty()) return;
+    if (bOnChangedIndexDirty || OnChangedIndexStructVersion != StructVersion) RebuildOnChangedIndex();
+
+    // 本帧被移除的锚点: 移除的节点已不在锚点表里, 按重建之前的锚点在第 0 层匹配, 匹配之后丢弃
+    TMap<FDaxNodeID, TArray<int32>> RemovedAnchors;
+    for (int32 i = 0; i < OnChangedBindings.Num(); ++i) {
+        FDaxOnChangedBinding& B = OnChangedBindings[i];
+        if (!B.RemovedAnchorID.IsValid()) continue;
+        if (B.IsValid()) RemovedAnchors.FindOrAdd(B.RemovedAnchorID).Add(i);
+        B.RemovedAnchorID = {};
+    }
+    if (OnChangedAnchorIndex.IsEmpty() && RemovedAnchors.IsEmpty()) return;
 
-    struct FAddRec {
-        FDaxNodeID ID;
-        uint32 Version;
-        FDaxNodeID Parent;
-        const UScriptStruct* Type;
-    };
-    struct FUpdRec {
-        FDaxNodeID ID;
-        uint32 Version;
-        FDaxNodeID Parent;
-        const UScriptStruct* Type;
+    auto SetRecordPosition = [](FDaxChangeRecord& Record, const EDaxParentEdgeKind EdgeKind, const uint16 EdgeIndex, const FName EdgeLabel) {
+        if (EdgeKind == EDaxParentEdgeKind::Array) Record.Index = EdgeIndex;
+        else if (EdgeKind == EDaxParentEdgeKind::Map) Record.Key = EdgeLabel;
     };
-    TArray<FDaxNodeID> Removes;
-    TArray<FAddRec> Adds;
-    TArray<FUpdRec> Updates;
 
-    auto WriteFullArray = [&](FArchive& Ar, const FDaxNodeID ID) {
-        auto* Node = Allocator.TryGetNode(ID);
-        auto* Arr = Node ? Node->GetArray() : nullptr;
-        uint32 Count = Arr ? static_cast<uint32>(Arr->Num()) : 0;
-        Ar.SerializeIntPacked(Count);
-        for (uint32 i = 0; i < Count; ++i) Ar << (*Arr)[i];
-    };
-    
-    auto WriteFullMap = [&](FArchive& Ar, const FDaxNodeID ID) {
-        auto* Node = Allocator.TryGetNode(ID);
-        auto* Map = Node ? Node->GetMap() : nullptr;
-        uint32 Count = Map ? static_cast<uint32>(Map->size()) : 0;
-        Ar.SerializeIntPacked(Count);
-        if (Map)
-            for (auto& Kv : *Map) {
-                Ar << Kv.first;
-                Ar << Kv.second;
-            }
-    };
-    
-    auto WriteMapDelta = [&](FArchive& Ar, const FDaxNodeID ID, const FDaxSetBaseState* Old) {
-        TArray<FName> RemovesKeys;
-        TArray<std::pair<FName, FDaxNodeID>> AddPairs;
-        TArray<std::pair<FName, FDaxNodeID>> RebindPairs;
-        const auto& OldMapRefOpt = Old->MapMirror.find(ID);
-        const FDaxMapType* OldMap = (OldMapRefOpt != Old->MapMirror.end()) ? &OldMapRefOpt->second : nullptr;
-        auto* Node = Allocator.TryGetNode(ID);
-        auto* NewMap = Node ? Node->GetMap() : nullptr;
-        if (OldMap) {
-            for (const auto& KV : *OldMap) {
-                const FName K = KV.first;
-                const FDaxNodeID OldChild = KV.second;
-                if (!NewMap || NewMap->find(K) == NewMap->end()) RemovesKeys.Add(K);
-                else {
-                    const FDaxNodeID NewChild = NewMap->at(K);
-                    if (!(NewChild == OldChild)) RebindPairs.Emplace(K, NewChild);
+    // 每个变化节点沿父链向上最多 OnChangedMaxDepth 层查锚点表, 开销与 变化数 x 深度 成正比.
+    // 聚合监听按子节点所在的位置(下标/键名)合并, 数组清空后重新填充时同一下标只保留一条, 取最强的变化种类
+    TArray<FDaxNodeID> FirstHit;
+    TBitArray<> Multiple(false, OnChangedBindings.Num());
+    FirstHit.SetNum(OnChangedBindings.Num());
+    TMap<int32, TMap<TPair<int32, FName>, FDaxChangeRecord>> Aggregated;
+    int32 HitCount = 0;
+    for (const auto& [ChangedID, Change] : FrameChangedNodes) {
+        // 移除的节点已经释放, 第 0 层只能匹配被移除的锚点, 之后从释放前记下的父节点开始向上
+        const bool bReleased = !Allocator.IsNodeValid(ChangedID);
+        if (bReleased && Change.Kind != EDaxChangeKind::Removed) continue;
+        const TArray<int32>* RemovedAnchorHits = bReleased ? RemovedAnchors.Find(ChangedID) : nullptr;
+        FDaxNodeID Below{};
+        FDaxNodeID Current = ChangedID;
+        for (int32 Level = 0; Level <= OnChangedMaxDepth; ++Level) {
+            const TArray<int32>* Found = nullptr;
+            if (Level == 0 && bReleased) Found = RemovedAnchorHits;
+            else if (Allocator.IsNodeValid(Current)) Found = OnChangedAnchorIndex.Find(Current);
+            else break;
+            if (Found) {
+                for (const int32 Index : *Found) {
+                    const FDaxOnChangedBinding& B = OnChangedBindings[Index];
+                    if (Level > B.Depth) continue;
+                    if (!FirstHit[Index].IsValid()) {
+                        FirstHit[Index] = ChangedID;
+                        ++HitCount;
+                    }
+                    else if (!(FirstHit[Index] == ChangedID)) {
+                        Multiple[Index] = true;
+                    }
+                    if (!B.bAggregate) continue;
+
+                    FDaxChangeRecord Record;
+                    Record.Kind = Level <= 1 ? Change.Kind : EDaxChangeKind::Value;
+                    if (bReleased && Below == ChangedID) SetRecordPosition(Record, Change.EdgeKind, Change.EdgeIndex, Change.EdgeLabel);
+                    else if (Below.IsValid()) SetRecordPosition(Record, Allocator.GetParentEdgeKind(Below), Allocator.GetParentEdgeIndex(Below), Allocator.GetParentEdgeLabel(Below));
+                    FDaxChangeRecord& Existing = Aggregated.FindOrAdd(Index).FindOrAdd(TPair<int32, FName>(Record.Index, Record.Key), Record);
+                    if (static_cast<uint8>(Record.Kind) > static_cast<uint8>(Existing.Kind)) Existing.Kind = Record.Kind;
                 }
             }
+            Below = Current;
+            Current = Level == 0 && bReleased ? Change.Parent : Allocator.GetParent(Current);
         }
-        if (NewMap) {
-            for (const auto& KV : *NewMap) {
-                const FName K = KV.first;
-                if (!OldMap || OldMap->find(K) == OldMap->end()) AddPairs.Emplace(K, KV.second);
-            }
-        }
-        uint32 Rm = RemovesKeys.Num();
-        uint32 Ad = static_cast<uint32>(AddPairs.Num());
-        uint32 Rb = static_cast<uint32>(RebindPairs.Num());
-        Ar.SerializeIntPacked(Rm);
-        Ar.SerializeIntPacked(Ad);
-        Ar.SerializeIntPacked(Rb);
-        for (const auto& K : RemovesKeys) Ar << const_cast<FName&>(K);
-        for (const auto& P : AddPairs) {
-            Ar << const_cast<FName&>(P.first);
-            Ar << const_cast<FDaxNodeID&>(P.second);
-        }
-        for (const auto& P : RebindPairs) {
-            Ar << const_cast<FName&>(P.first);
-            Ar << const_cast<FDaxNodeID&>(P.second);
+    }
+    if (HitCount == 0) return;
+
+    PendingOnChanged.Reserve(PendingOnChanged.Num() + HitCount);
+    for (int32 i = 0; i < OnChangedBindings.Num(); ++i) {
+        if (!FirstHit[i].IsValid()) continue;
+        const FDaxOnChangedBinding& B = OnChangedBindings[i];
+        FDaxPendingOnChanged& Pending = PendingOnChanged.AddDefaulted_GetRef();
+        Pending.BindingIndex = i;
+        if (B.bAggregate) {
+            Pending.ChangedID = B.AnchorID;
+            Aggregated.FindChecked(i).GenerateValueArray(Pending.Changes);
+            // 监听位置自身的记录排在最前, 其余按下标、键名排序
+            Pending.Changes.Sort([](const FDaxChangeRecord& Lhs, const FDaxChangeRecord& Rhs) {
+                const bool bLhsSelf = Lhs.Index == INDEX_NONE && Lhs.Key.IsNone();
+                const bool bRhsSelf = Rhs.Index == INDEX_NONE && Rhs.Key.IsNone();
+                if (bLhsSelf != bRhsSelf) return bLhsSelf;
+                if (Lhs.Index != Rhs.Index) return Lhs.Index < Rhs.Index;
+                return Lhs.Key.LexicalLess(Rhs.Key);
+            });
+            continue;
         }
-        return Rm + Ad + Rb;
-    };
-    
-    auto WriteArrayDelta = [&](FArchive& Ar, const FDaxNodeID ID, const FDaxSetBaseState* Old) {
-        const auto& OldArrRefOpt = Old->ArrayMirror.find(ID);
-        const TArray<FDaxNodeID>* OldArr = (OldArrRefOpt != Old->ArrayMirror.end()) ? &OldArrRefOpt->second : nullptr;
-        auto* Node = Allocator.TryGetNode(ID);
-        auto* NewArr = Node ? Node->GetArray() : nullptr;
-        const int32 oldN = OldArr ? OldArr->Num() : 0;
-        const int32 newN = NewArr ? NewArr->Num() : 0;
-        if (newN == 0) {
-            uint8 kind = 1;
-            Ar << kind;
-            return 1u;
-        }
-        int32 L = 0;
-        while (L < oldN && L < newN) {
-            if ((*OldArr)[L] != (*NewArr)[L]) break;
-            ++L;
-        }
-        int32 R = 0;
-        while ((oldN - R - 1) >= L && (newN - R - 1) >= L) {
-            const FDaxNodeID A = (*OldArr)[oldN - R - 1];
-            const FDaxNodeID B = (*NewArr)[newN - R - 1];
-            if (!(A == B)) break;
-            ++R;
-        }
-        const int32 oldMid = oldN - L - R;
-        const int32 newMid = newN - L - R;
-        uint8 kind = 0;
-        Ar << kind;
-        uint32 Start = static_cast<uint32>(L);
-        uint32 OldCount = static_cast<uint32>(oldMid);
-        uint32 NewCount = static_cast<uint32>(newMid);
-        Ar.SerializeIntPacked(Start);
-        Ar.SerializeIntPacked(OldCount);
-        Ar.SerializeIntPacked(NewCount);
-        for (int32 i = 0; i < newMid; ++i) {
-            FDaxNodeID C = (*NewArr)[L + i];
-            Ar << C;
-        }
-        return static_cast<uint32>(1);
-    };
+        Pending.ChangedID = !Multiple[i] && Allocator.IsNodeValid(FirstHit[i]) ? FirstHit[i] : B.AnchorID;
+    }
+}
 
-    for (int32 ChunkIndex = 0; ChunkIndex < MaxChunkCount; ++ChunkIndex) {
-        const auto OldMeta = (OldState && OldState->ChildStates.IsValidIndex(ChunkIndex))
-                                 ? OldState->ChildStates[ChunkIndex].Get()
-                                 : nullptr;
-        const auto NewMeta = Allocator.GetChunkMetadata(ChunkIndex);
-        const uint32 MainUsedMask = NewMeta ? NewMeta->UsedMask : 0;
-        const uint32 OldUsedMask = OldMeta ? OldMeta->UsedMask : 0;
-        if (MainUsedMask == 0 && OldUsedMask == 0) continue;
-        if (OldMeta && NewMeta) {
-            if (OldUsedMask == MainUsedMask) {
-                if (memcmp(OldMeta->Generations, NewMeta->Generations, sizeof(NewMeta->Generations)) == 0 &&
-                    memcmp(OldMeta->Versions, NewMeta->Versions, sizeof(NewMeta->Versions)) == 0 &&
-                    memcmp(OldMeta->Parent, NewMeta->Parent, sizeof(NewMeta->Parent)) == 0 &&
-                    memcmp(OldMeta->ValueType, NewMeta->ValueType, sizeof(NewMeta->ValueType)) == 0) {
-                    continue;
-                }
-            }
+void FDaxSet::DispatchOnChanged() {
+    if (PendingOnChanged.IsEmpty()) return;
+    // 派发期间新增的监听延后加入、解绑只做标记, 回调执行时绑定表不会移动
+    TArray<FDaxPendingOnChanged> Dispatching = MoveTemp(PendingOnChanged);
+    PendingOnChanged.Reset();
+    bDispatchingOnChanged = true;
+    for (const FDaxPendingOnChanged& Pending : Dispatching) {
+        const FDaxOnChangedBinding& B = OnChangedBindings[Pending.BindingIndex];
+        if (!B.IsValid()) continue;
+        if (B.bAggregate) {
+            if (B.NativeAggregateDelegate.IsBound()) B.NativeAggregateDelegate.Execute(*this, Pending.ChangedID, Pending.Changes);
+            else B.AggregateDelegate.Execute(B.ListenPath, Pending.Changes);
+        }
+        else if (B.NativeDelegate.IsBound()) {
+            B.NativeDelegate.Execute(*this, Pending.ChangedID);
         }
-        uint32 CombineMask = MainUsedMask | OldUsedMask;
-        while (CombineMask) {
-            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(CombineMask));
-            const uint32 CurrentBit = (1u << LocalIndex);
-            const bool bInNew = (MainUsedMask & CurrentBit) != 0;
-            const bool bInOld = (OldUsedMask & CurrentBit) != 0;
-            const uint16 GlobalIndex = static_cast<uint16>((ChunkIndex << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex);
-            if (bInNew && bInOld) {
-                const uint16 OldGen = OldMeta->Generations[LocalIndex];
-                const uint16 NewGen = NewMeta->Generations[LocalIndex];
-                const FDaxNodeID OldID(GlobalIndex, OldGen);
-                const FDaxNodeID NewID(GlobalIndex, NewGen);
-                if (!(OldID == NewID)) {
-                    Removes.Add(OldID);
-                    Adds.Add(FAddRec{
-                        NewID, NewMeta->Versions[LocalIndex], NewMeta->Parent[LocalIndex],
-                        NewMeta->ValueType[LocalIndex]
-                    });
-                }
-                else {
-                    bool bChanged = false;
-                    bChanged |= (OldMeta->Versions[LocalIndex] != NewMeta->Versions[LocalIndex]);
-                    bChanged |= !(OldMeta->Parent[LocalIndex] == NewMeta->Parent[LocalIndex]);
-                    bChanged |= (OldMeta->ValueType[LocalIndex] != NewMeta->ValueType[LocalIndex]);
-                    if (bChanged)
-                        Updates.Add(FUpdRec{
-                            NewID, NewMeta->Versions[LocalIndex], NewMeta->Parent[LocalIndex],
-                            NewMeta->ValueType[LocalIndex]
-                        });
-                }
-            }
-            else if (!bInNew && bInOld) {
-                const uint16 OldGen = OldMeta->Generations[LocalIndex];
-                Removes.Add(FDaxNodeID(GlobalIndex, OldGen));
-            }
-            else if (bInNew && !bInOld) {
-                const uint16 NewGen = NewMeta->Generations[LocalIndex];
-                Adds.Add(FAddRec{
-                    FDaxNodeID(GlobalIndex, NewGen), NewMeta->Versions[LocalIndex], NewMeta->Parent[LocalIndex],
-                    NewMeta->ValueType[LocalIndex]
-                });
-            }
-            CombineMask &= ~CurrentBit;
+        else {
+            FDaxVisitor Position = Pending.ChangedID == B.AnchorID ? B.ListenPath : GetVisitorFromNodeID(Pending.ChangedID);
+            if (!Position.IsValid()) Position = B.ListenPath;
+            B.Delegate.Execute(Position);
         }
     }
+    bDispatchingOnChanged = false;
 
-    uint32 AddsCount = Adds.Num();
-    uint32 RemovesCount = Removes.Num();
-    uint32 UpdatesCount = Updates.Num();
-    Writer.SerializeIntPacked(AddsCount);
-    Writer.SerializeIntPacked(RemovesCount);
-    Writer.SerializeIntPacked(UpdatesCount);
+    if (bOnChangedCompactPending) {
+        OnChangedBindings.RemoveAll([](const FDaxOnChangedBinding& B) { return B.bRemoved; });
+        bOnChangedCompactPending = false;
+        bOnChangedIndexDirty = true;
+    }
+    if (!DeferredOnChangedBindings.IsEmpty()) {
+        OnChangedBindings.Append(MoveTemp(DeferredOnChangedBindings));
+        DeferredOnChangedBindings.Reset();
+        bOnChangedIndexDirty = true;
+    }
+}
 
-    for (auto ID : Removes) { Writer << ID; }
-    for (const auto& R : Adds) {
-        const bool IsValueType = (R.Type && R.Type != FDaxFakeTypeEmpty::StaticStruct() && R.Type !=
-            FDaxFakeTypeArray::StaticStruct() && R.Type != FDaxFakeTypeMap::StaticStruct());
-        const bool IsContainer = (R.Type == FDaxFakeTypeArray::StaticStruct() || R.Type ==
-            FDaxFakeTypeMap::StaticStruct());
-        bool bSendValue = false;
-        if (IsValueType) {
-            if (auto* Node = Allocator.TryGetNode(R.ID)) {
-                if (Node->IsValue()) {
-                    auto SV = Node->TryGetValueGenericMutable();
-                    auto SS = SV.GetScriptStruct();
-                    bSendValue = (SS == R.Type);
+void FDaxSet::PrepareOldValueCapture() {
+    if (OnChangedBindings.IsEmpty()) {
+        OldValueCaptureDepth = INDEX_NONE;
+        return;
+    }
+    if (bOnChangedIndexDirty || OnChangedIndexStructVersion != StructVersion) RebuildOnChangedIndex();
+}
+
+void FDaxSet::CaptureOldValue(const FDaxNodeID ID) {
+    if (OldValueCaptureDepth == INDEX_NONE || OldValueMap.contains(ID)) return;
+    const FDaxNode* Node = Allocator.TryGetNode(ID);
+    if (!Node || !Node->IsValue()) return;
+
+    // 沿父链查找开启了旧值的监听, 与派发使用同一张锚点表
+    bool bWanted = false;
+    FDaxNodeID Current = ID;
+    for (int32 Level = 0; Level <= OldValueCaptureDepth && !bWanted && Allocator.IsNodeValid(Current); ++Level) {
+        if (const auto* Found = OnChangedAnchorIndex.Find(Current)) {
+            for (const int32 Index : *Found) {
+                const FDaxOnChangedBinding& B = OnChangedBindings[Index];
+                if (B.bCaptureOldValues && !B.bRemoved && Level <= B.Depth) {
+                    bWanted = true;
+                    break;
                 }
             }
         }
-        const bool bSendCFull = IsContainer;
-        uint8 Flags = ArzDax::DaxMakeDeltaFlags(EDaxDeltaOp::Add, true, true, bSendValue, false, bSendCFull);
-        Writer << const_cast<FDaxNodeID&>(R.ID);
-        Writer << Flags;
-        Writer << const_cast<FDaxNodeID&>(R.Parent);
-        UObject* TempTypeObject = const_cast<UScriptStruct*>(R.Type);
-        DeltaParms.Map->SerializeObject(Writer, UScriptStruct::StaticClass(), TempTypeObject);
-        if (bSendValue) {
-            if (auto* Node = Allocator.TryGetNode(R.ID)) Node->SerializeValueData(Writer, DeltaParms.Map, R.Type);
-        }
-        else if (bSendCFull) {
-            if (R.Type == FDaxFakeTypeArray::StaticStruct()) WriteFullArray(Writer, R.ID);
-            else if (R.Type == FDaxFakeTypeMap::StaticStruct()) WriteFullMap(Writer, R.ID);
-        }
+        Current = Allocator.GetParent(Current);
     }
+    if (!bWanted) return;
+
+    const FConstStructView Value = Node->TryGetValueGeneric();
+    const UScriptStruct* Type = Value.GetScriptStruct();
+    if (!Type) return;
+    void* Memory = OldValueArena.Alloc(Type->GetStructureSize(), Type->GetMinAlignment());
+    Type->InitializeStruct(Memory);
+    Type->CopyScriptStruct(Memory, Value.GetMemory());
+    OldValueMap.emplace(ID, FDaxOldValue{Type, Memory});
+}
 
-    for (const auto& R : Updates) {
-        const uint16 ChunkIndex = static_cast<uint16>(R.ID.Index >> DAX_NODE_POOR_CHUNK_SHIFT);
-        const uint16 LocalIndex = static_cast<uint16>(R.ID.Index & DAX_NODE_POOR_CHUNK_MASK);
-        const auto* OldMeta = (OldState && OldState->ChildStates.IsValidIndex(ChunkIndex))
-                                  ? OldState->ChildStates[ChunkIndex].Get()
-                                  : nullptr;
-        const auto* NewMeta = Allocator.GetChunkMetadata(ChunkIndex);
-        bool bParentChanged = false, bTypeChanged = false, bVersionChanged = false;
-        if (OldMeta && NewMeta) {
-            bParentChanged = !(OldMeta->Parent[LocalIndex] == NewMeta->Parent[LocalIndex]);
-            bTypeChanged = (OldMeta->ValueType[LocalIndex] != NewMeta->ValueType[LocalIndex]);
+void FDaxSet::ReleaseOldValues() {
+    if (OldValueMap.empty()) return;
+    for (const auto& [ID, OldValue] : OldValueMap) {
+        OldValue.Type->DestroyStruct(OldValue.Memory);
+    }
+    OldValueMap.clear();
+    OldValueArena.Flush();
+}
+
+FConstStructView FDaxSet::TryGetOldValueByNodeID(const FDaxNodeID NodeID) const {
+    if (const auto Found = OldValueMap.findPtr(NodeID)) {
+        return FConstStructView(Found->Type, static_cast<const uint8*>(Found->Memory));
+    }
+    return {};
+}
+
+void FDaxSet::SetPropertyDeltaEnabled(const UScriptStruct* Type, const bool bEnabled) {
+    FDaxPropertyDelta::SetEnabled(Type, bEnabled);
+}
+
+bool FDaxSet::SetNetPriority(const FDaxVisitor& Position, const int32 Priority) {
+    if (!Position.HasData()) return false;
+    const FDaxNodeID ID = Position.GetCachedNodeID();
+    if (Priority == 0) NetPriorities.Remove(ID);
+    else NetPriorities.Add(ID, Priority);
+    return true;
+}
+
+bool FDaxSet::SetNetUpdateInterval(const FDaxVisitor& Position, const float IntervalSeconds) {
+    if (!Position.HasData()) return false;
+    const FDaxNodeID ID = Position.GetCachedNodeID();
+    for (auto It = NetUpdateIntervals.CreateIterator(); It; ++It) {
+        if (!Allocator.IsNodeValid(It.Key())) It.RemoveCurrent();
+    }
+    if (IntervalSeconds <= 0.f) NetUpdateIntervals.Remove(ID);
+    else NetUpdateIntervals.Add(ID, IntervalSeconds);
+    return true;
+}
+
+bool FDaxSet::SetNetCondition(const FDaxVisitor& Position, const EDaxNetCondition Condition, FDaxNetConditionPredicate Predicate) {
+    if (!Position.HasData()) return false;
+    if (Condition == EDaxNetCondition::Custom && !Predicate.IsBound()) return false;
+    // Iris 的量化状态所有连接共用, 无法按连接过滤; 拒绝设置, 避免本应隐藏的子树被同步给所有连接
+    if (Condition != EDaxNetCondition::None && ParentComponent.IsValid() && ParentComponent->IsUsingIrisReplication()) {
+        ensureMsgf(false, TEXT("DaxSet: net conditions are not supported under Iris replication"));
+        return false;
+    }
+    const FDaxNodeID ID = Position.GetCachedNodeID();
+    for (auto It = NetConditions.CreateIterator(); It; ++It) {
+        if (!Allocator.IsNodeValid(It.Key())) It.RemoveCurrent(); // 顺便清理已释放的子树根
+    }
+    if (Condition == EDaxNetCondition::None) NetConditions.Remove(ID);
+    else NetConditions.Add(ID, FDaxNetConditionEntry{Condition, MoveTemp(Predicate)});
+    RefreshNetConditions();
+    return true;
+}
+
+void FDaxSet::RefreshNetConditions() {
+    if (!bRunningOnServer) return;
+    ++NetConditionSerial;
+    if (ParentComponent.IsValid()) {
+        ParentComponent->MarkDirty();
+    }
+}
+
+bool FDaxSet::IsNetOwnerConnection(UPackageMap* Map) const {
+    if (NetConditions.IsEmpty()) return false;
+    UPackageMapClient* PackageMap = Cast<UPackageMapClient>(Map);
+    const UNetConnection* Connection = PackageMap ? PackageMap->GetConnection() : nullptr;
+    const AActor* Owner = ParentComponent.IsValid() ? ParentComponent->GetOwner() : nullptr;
+    return Owner && Connection && Owner->GetNetConnection() == Connection;
+}
+
+void FDaxSet::BuildNetFilter(UPackageMap* Map, FDaxNetFilter& OutFilter) const {
+    if (NetConditions.IsEmpty()) return;
+    UPackageMapClient* PackageMap = Cast<UPackageMapClient>(Map);
+    const UNetConnection* Connection = PackageMap ? PackageMap->GetConnection() : nullptr;
+    const bool bIsOwner = IsNetOwnerConnection(Map);
+    OutFilter.bOwnerConnection = bIsOwner;
+    for (const auto& Pair : NetConditions) {
+        const FDaxNodeID Root = Pair.Key;
+        if (!Allocator.IsNodeValid(Root) || OutFilter.IsExcluded(Root)) continue;
+        bool bVisible = true;
+        switch (Pair.Value.Condition) {
+            case EDaxNetCondition::OwnerOnly: bVisible = bIsOwner; break;
+            case EDaxNetCondition::SkipOwner: bVisible = !bIsOwner; break;
+            case EDaxNetCondition::Custom: bVisible = Pair.Value.Predicate.IsBound() && Pair.Value.Predicate.Execute(Connection); break;
+            default: break;
+        }
+        if (bVisible) continue;
+        OutFilter.HiddenRoots.Add(Root);
+        CollectNetHiddenSubtree(Root, OutFilter);
+    }
+    // 嵌套在被过滤子树里的条件根不再单独作为空节点同步
+    for (auto It = OutFilter.HiddenRoots.CreateIterator(); It; ++It) {
+        if (OutFilter.HiddenNodes.Contains(*It)) It.RemoveCurrent();
+    }
+}
+
+void FDaxSet::CollectNetHiddenSubtree(const FDaxNodeID ID, FDaxNetFilter& OutFilter) const {
+    const ArzDax::FDaxNode* Node = Allocator.TryGetNode(ID);
+    if (!Node) return;
+    auto Visit = [&](const FDaxNodeID Child) {
+        if (!Child.IsValid() || !Allocator.IsNodeValid(Child)) return;
+        bool bAlreadyHidden = false;
+        OutFilter.HiddenNodes.Add(Child, &bAlreadyHidden);
+        if (!bAlreadyHidden) CollectNetHiddenSubtree(Child, OutFilter);
+    };
+    if (const auto* Arr = Node->GetArray()) {
+        for (const FDaxNodeID& Child : *Arr) Visit(Child);
+    }
+    else if (const FDaxMapType* Map = Node->GetMap()) {
+        for (const auto& KV : *Map) Visit(KV.second);
+    }
+}
+
+bool FDaxSet::ConsumeHydratedEvent() {
+    const bool bFire = bClientHydratedEvent;
+    bClientHydratedEvent = false;
+    return bFire;
+}
+
+uint32 FDaxSet::GetPredictionKey(const FDaxVisitor& Position) const {
+    if (!Position.HasData()) return 0;
+    const auto It = OverlayMap.find(Position.GetCachedNodeID());
+    return It != OverlayMap.end() ? It->second.PredictionKey : 0;
+}
+
+bool FDaxSet::SetPredictionReconcileCallback(const FDaxVisitor& Position, FDaxOnPredictionReconciled Callback) {
+    if (!Position.HasData()) return false;
+    const FDaxNodeID ID = Position.GetCachedNodeID();
+    if (Callback.IsBound()) PredictionCallbacks.Add(ID, MoveTemp(Callback));
+    else PredictionCallbacks.Remove(ID);
+    return true;
+}
+
+void FDaxSet::ReconcilePredictions(const TArray<FDaxNodeID>* TouchedIDs) {
+    if (OverlayMap.empty()) return;
+    TArray<FDaxNodeID> AllIDs;
+    if (!TouchedIDs) {
+        AllIDs.Reserve(static_cast<int32>(OverlayMap.size()));
+        for (const auto& KV : OverlayMap) AllIDs.Add(KV.first);
+        TouchedIDs = &AllIDs;
+    }
+    const bool bCheckWatermark = TouchedIDs != &AllIDs;
+    for (const FDaxNodeID ID : *TouchedIDs) {
+        const auto It = OverlayMap.find(ID);
+        if (It == OverlayMap.end()) continue;
+        EDaxPredictionResult Result = EDaxPredictionResult::Removed;
+        if (Allocator.IsNodeValid(ID)) {
+            const FDaxPredictionEntry& Pending = It->second;
+            if (bCheckWatermark && Pending.bSentToServer && static_cast<int32>(Pending.PredictionKey - ClientPredictionWatermark) > 0) continue;
+            Result = IsPredictionMatched(*It->second.Node, Allocator.TryGetNode(ID)) ? EDaxPredictionResult::Confirmed : EDaxPredictionResult::Overridden;
+        }
+        FDaxPredictionEntry Entry = MoveTemp(It->second);
+        OverlayMap.erase(It);
+        ResolvePrediction(ID, MoveTemp(Entry), Result);
+    }
+}
+
+void FDaxSet::ResolvePrediction(const FDaxNodeID ID, FDaxPredictionEntry&& Entry, const EDaxPredictionResult Result) {
+    // 可见值从预测值回到权威值, 监听者需要看到这次变化
+    if (Result != EDaxPredictionResult::Confirmed) MarkFrameChanged(ID, EDaxChangeKind::Value);
+    DAX_NET_SYNC_LOG(Log, "Prediction {0} on {1} resolved as {2}", Entry.PredictionKey, ID.ToString(), static_cast<uint8>(Result));
+    if (!PredictionCallbacks.Contains(ID)) return;
+    ResolvedPredictions.Add(FDaxPredictionResolved{ID, Entry.PredictionKey, Result, MoveTemp(Entry.Node)});
+}
+
+void FDaxSet::FlushPredictions(const double Now) {
+    if (bRunningOnServer) return;
+    const double Timeout = CVarDaxNetPredictionTimeout.GetValueOnGameThread();
+    if (Timeout > 0.0 && !OverlayMap.empty()) {
+        TArray<FDaxNodeID> Expired;
+        for (const auto& KV : OverlayMap) {
+            if (Now - KV.second.PredictTime >= Timeout) Expired.Add(KV.first);
+        }
+        for (const FDaxNodeID ID : Expired) {
+            const auto It = OverlayMap.find(ID);
+            FDaxPredictionEntry Entry = MoveTemp(It->second);
+            OverlayMap.erase(It);
+            ResolvePrediction(ID, MoveTemp(Entry), EDaxPredictionResult::TimedOut);
+        }
+    }
+    if (ResolvedPredictions.IsEmpty()) return;
+
+    // 回调里可能再次写入预测或改动回调表, 先取走本批结果
+    TArray<FDaxPredictionResolved> Pending = MoveTemp(ResolvedPredictions);
+    ResolvedPredictions.Reset();
+    for (FDaxPredictionResolved& Resolved : Pending) {
+        const FDaxOnPredictionReconciled* Found = PredictionCallbacks.Find(Resolved.ID);
+        if (!Found) continue;
+        const FDaxOnPredictionReconciled Callback = *Found;
+        if (Resolved.Result == EDaxPredictionResult::Removed) PredictionCallbacks.Remove(Resolved.ID);
+        const FConstStructView Predicted = Resolved.Predicted.IsValid() ? Resolved.Predicted->TryGetValueGeneric() : FConstStructView();
+        Callback.ExecuteIfBound(Resolved.PredictionKey, Resolved.Result, Predicted);
+    }
+}
+
+void FDaxSet::AckPredictions(const TConstArrayView<uint32> PredictionKeys, const EDaxPredictionResult Result) {
+    if (PredictionKeys.IsEmpty() || OverlayMap.empty()) return;
+    // 只结算键仍然一致的条目, 之后又被本地改写的预测继续等待
+    TArray<FDaxNodeID> Matched;
+    for (const auto& KV : OverlayMap) {
+        if (PredictionKeys.Contains(KV.second.PredictionKey)) Matched.Add(KV.first);
+    }
+    for (const FDaxNodeID ID : Matched) {
+        const auto It = OverlayMap.find(ID);
+        FDaxPredictionEntry Entry = MoveTemp(It->second);
+        OverlayMap.erase(It);
+        ResolvePrediction(ID, MoveTemp(Entry), Result);
+    }
+}
+
+bool FDaxSet::ConsumeWriteBatch(FDaxWriteBatch& OutBatch, const bool bDeliver) {
+    if (PendingWriteIDs.IsEmpty()) return false;
+    PendingWriteIDs.Sort([](const FDaxNodeID A, const FDaxNodeID B) { return A.Index < B.Index; });
+    int32 Consumed = 0;
+    for (; Consumed < PendingWriteIDs.Num() && OutBatch.Entries.Num() < static_cast<int32>(FDaxWriteBatch::MaxEntries); ++Consumed) {
+        const FDaxNodeID ID = PendingWriteIDs[Consumed];
+        const auto It = OverlayMap.find(ID);
+        if (It == OverlayMap.end()) continue; // 发送前已经结算
+        It->second.bSentToServer = bDeliver;
+        FDaxWriteBatchEntry& Entry = OutBatch.Entries.AddDefaulted_GetRef();
+        Entry.ID = ID;
+        Entry.PredictionKey = It->second.PredictionKey;
+        if (const FConstStructView Value = It->second.Node->TryGetValueGeneric(); Value.IsValid()) {
+            Entry.Value.InitializeAs(Value.GetScriptStruct(), Value.GetMemory());
+        }
+    }
+    // 超出单批上限的留到下一帧
+    PendingWriteIDs.RemoveAt(0, Consumed, EAllowShrinking::No);
+    return !OutBatch.Entries.IsEmpty();
+}
+
+void FDaxSet::ApplyWriteBatch(const FDaxWriteBatch& Batch, const TFunctionRef<bool(const FDaxVisitor&, FConstStructView)> Authorize,
+                              TArray<uint32>& OutRejected, TArray<uint32>& OutUnchanged) {
+    if (!bRunningOnServer) return;
+    for (const FDaxWriteBatchEntry& Entry : Batch.Entries) {
+        // 无论结果如何都推进水位, 之后的同步让客户端知道这次写入已经被处理
+        if (static_cast<int32>(Entry.PredictionKey - ProcessedPredictionKey) > 0) ProcessedPredictionKey = Entry.PredictionKey;
+        // 客户端只能预测已存在的值/空节点, 过期 ID 与容器节点直接拒绝
+        const FDaxVisitor Position = GetVisitorFromNodeID(Entry.ID);
+        if (!Position.HasData() || !(Position.GetCachedNodeID() == Entry.ID) || IsNodeArray(Entry.ID) || IsNodeMap(Entry.ID)) {
+            OutRejected.Add(Entry.PredictionKey);
+            continue;
+        }
+        const FConstStructView NewValue = Entry.Value.IsValid() ? FConstStructView(Entry.Value) : FConstStructView();
+        if (!Authorize(Position, NewValue)) {
+            OutRejected.Add(Entry.PredictionKey);
+            continue;
+        }
+        const FDaxResultDetail Result = NewValue.IsValid() ? Position.TrySetValue(NewValue) : Position.TrySetToEmpty();
+        if (Result == EDaxResult::SameValueNotChange) OutUnchanged.Add(Entry.PredictionKey);
+        else if (!Result.IsOk()) OutRejected.Add(Entry.PredictionKey);
+    }
+}
+
+FDaxVisitor FDaxSet::GetVisitorFromNodeID(const FDaxNodeID ID) const {
+    if (!Allocator.IsNodeValid(ID)) return {};
+    static constexpr int32 MaxPathDepth = 64;
+    TArray<TVariant<FName, int32>> Path;
+    FDaxNodeID Current = ID;
+    while (!(Current == RootID)) {
+        TVariant<FName, int32>& Segment = Path.AddDefaulted_GetRef();
+        switch (Allocator.GetParentEdgeKind(Current)) {
+        case EDaxParentEdgeKind::Array: Segment.Set<int32>(Allocator.GetParentEdgeIndex(Current)); break;
+        case EDaxParentEdgeKind::Map: Segment.Set<FName>(Allocator.GetParentEdgeLabel(Current)); break;
+        default: return {};
+        }
+        Current = Allocator.GetParent(Current);
+        if (!Current.IsValid() || Path.Num() > MaxPathDepth) return {};
+    }
+    Algo::Reverse(Path);
+    return FDaxVisitor(const_cast<FDaxSet*>(this), LiveToken, Path);
+}
+
+int32 FDaxSet::GetNetPriorityAndDepth(const FDaxNodeID ID, int32& OutDepth) const {
+    int32 Priority = 0;
+    bool bFoundPriority = NetPriorities.IsEmpty();
+    OutDepth = 0;
+    FDaxNodeID Current = ID;
+    while (Current.IsValid() && OutDepth < 256) {
+        if (!bFoundPriority) {
+            if (const int32* Found = NetPriorities.Find(Current)) {
+                Priority = *Found;
+                bFoundPriority = true;
+            }
+        }
+        Current = Allocator.GetParent(Current);
+        if (Current.IsValid()) ++OutDepth;
+    }
+    return Priority;
+}
+
+float FDaxSet::GetNetUpdateInterval(const FDaxNodeID ID, FDaxNodeID& OutRoot) const {
+    if (NetUpdateIntervals.IsEmpty()) return 0.f;
+    FDaxNodeID Current = ID;
+    for (int32 Depth = 0; Current.IsValid() && Depth < 256; ++Depth) {
+        if (const float* Found = NetUpdateIntervals.Find(Current)) {
+            OutRoot = Current;
+            return *Found;
+        }
+        Current = Allocator.GetParent(Current);
+    }
+    return 0.f;
+}
+
+TSharedPtr<const FDaxSetSnapshot> FDaxSet::AcquireNetSnapshot() {
+    const uint32 Epoch = Allocator.GetChangeEpoch();
+    const int32 ChunkCount = static_cast<int32>(Allocator.GetChunkCount());
+    const FDaxSetSnapshot* Prev = NetSnapshot.Get();
+    if (Prev && Prev->DataVersion == DataVersion && Prev->ChunkEpoch == Epoch && Prev->GetChunkCount() == ChunkCount) {
+        return NetSnapshot; // 同一版本的连接直接共享
+    }
+
+    TSharedPtr<FDaxSetSnapshot> Snapshot = MakeShared<FDaxSetSnapshot>();
+    Snapshot->DataVersion = DataVersion;
+    Snapshot->ChunkEpoch = Epoch;
+    Snapshot->Chunks.SetNum(ChunkCount);
+
+    for (int32 ci = 0; ci < ChunkCount; ++ci) {
+        const FDaxChunkSnapshot* PrevChunk = Prev ? Prev->GetChunk(ci) : nullptr;
+        if (PrevChunk && Allocator.GetChunkEpoch(static_cast<uint16>(ci)) <= Prev->ChunkEpoch) {
+            Snapshot->Chunks[ci] = Prev->Chunks[ci]; // 块自上个快照以来没有变化
+            continue;
+        }
+
+        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(static_cast<uint16>(ci));
+        if (!Meta) continue;
+        TSharedPtr<FDaxChunkSnapshot> Chunk = MakeShared<FDaxChunkSnapshot>();
+        Chunk->Meta = *Meta;
+        Chunk->Epoch = Allocator.GetChunkEpoch(static_cast<uint16>(ci));
+
+        uint32 Mask = Meta->UsedMask;
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            const uint32 CurrentBit = (1u << LocalIndex);
+            Mask &= ~CurrentBit;
+
+            const UScriptStruct* Type = Meta->ValueType[LocalIndex];
+            const bool IsArrayType = (Type == FDaxFakeTypeArray::StaticStruct());
+            const bool IsMapType = (Type == FDaxFakeTypeMap::StaticStruct());
+            const bool IsShadowedValue = !IsArrayType && !IsMapType && FDaxPropertyDelta::IsEnabled(Type);
+            if (!IsArrayType && !IsMapType && !IsShadowedValue) continue;
+
+            // 容器成员变化与值变化都会 Bump 节点自身的版本, 所以 代/版本/类型 都没变时可以复用旧镜像
+            const bool bReusable = PrevChunk && (PrevChunk->Meta.UsedMask & CurrentBit) != 0 &&
+                PrevChunk->Meta.Generations[LocalIndex] == Meta->Generations[LocalIndex] &&
+                PrevChunk->Meta.Versions[LocalIndex] == Meta->Versions[LocalIndex] &&
+                PrevChunk->Meta.ValueType[LocalIndex] == Type;
+
+            const FDaxNodeID NodeID(static_cast<uint16>((ci << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex), Meta->Generations[LocalIndex]);
+            if (IsShadowedValue) {
+                if (bReusable && PrevChunk->Values[LocalIndex].IsValid()) {
+                    Chunk->Values[LocalIndex] = PrevChunk->Values[LocalIndex];
+                }
+                else if (const FDaxNode* Node = Allocator.TryGetNode(NodeID)) {
+                    const FConstStructView SV = Node->TryGetValueGeneric();
+                    if (SV.GetScriptStruct() == Type) {
+                        Chunk->Values[LocalIndex] = MakeShared<FInstancedStruct>(SV);
+                    }
+                }
+            }
+            else if (IsArrayType) {
+                if (bReusable && PrevChunk->Arrays[LocalIndex].IsValid()) {
+                    Chunk->Arrays[LocalIndex] = PrevChunk->Arrays[LocalIndex];
+                }
+                else if (const FDaxNode* Node = Allocator.TryGetNode(NodeID)) {
+                    if (const auto* Arr = Node->GetArray()) {
+                        TSharedPtr<TArray<FDaxNodeID>> Copy = MakeShared<TArray<FDaxNodeID>>();
+                        *Copy = *Arr;
+                        Chunk->Arrays[LocalIndex] = Copy;
+                    }
+                }
+            }
+            else {
+                if (bReusable && PrevChunk->Maps[LocalIndex].IsValid()) {
+                    Chunk->Maps[LocalIndex] = PrevChunk->Maps[LocalIndex];
+                }
+                else if (const FDaxNode* Node = Allocator.TryGetNode(NodeID)) {
+                    if (const FDaxMapType* Map = Node->GetMap()) {
+                        Chunk->Maps[LocalIndex] = MakeShared<FDaxMapType>(*Map);
+                    }
+                }
+            }
+        }
+        Snapshot->Chunks[ci] = Chunk;
+    }
+
+    NetSnapshot = Snapshot;
+    return NetSnapshot;
+}
+
+TRefCountPtr<const FDaxIrisState> FDaxSet::Iris_Quantize() {
+    bRunningOnServer = true;
+    Allocator.FlushDirtyChunks();
+    const uint32 Epoch = Allocator.GetChangeEpoch();
+    const int32 ChunkCount = static_cast<int32>(Allocator.GetChunkCount());
+    const FDaxIrisState* Prev = IrisQuantizedState.GetReference();
+    if (Prev && Prev->DataVersion == DataVersion && Prev->StructVersion == StructVersion && Prev->ChunkEpoch == Epoch && Prev->Chunks.Num() == ChunkCount &&
+        Prev->PredictionWatermark == ProcessedPredictionKey) {
+        return IrisQuantizedState;
+    }
+
+    TRefCountPtr<FDaxIrisState> State = new FDaxIrisState();
+    State->DataVersion = DataVersion;
+    State->StructVersion = StructVersion;
+    State->ChunkEpoch = Epoch;
+    State->PredictionWatermark = ProcessedPredictionKey;
+    State->Chunks.SetNum(ChunkCount);
+
+    for (int32 ci = 0; ci < ChunkCount; ++ci) {
+        const FDaxIrisChunk* PrevChunk = Prev ? Prev->GetChunk(ci) : nullptr;
+        if (PrevChunk && Allocator.GetChunkEpoch(static_cast<uint16>(ci)) <= Prev->ChunkEpoch) {
+            State->Chunks[ci] = Prev->Chunks[ci]; // 块自上次量化以来没有变化
+            continue;
+        }
+        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(static_cast<uint16>(ci));
+        if (!Meta) continue;
+
+        TSharedPtr<FDaxIrisChunk> Chunk = MakeShared<FDaxIrisChunk>();
+        Chunk->UsedMask = Meta->UsedMask;
+        uint32 Mask = Meta->UsedMask;
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            const UScriptStruct* Type = Meta->ValueType[LocalIndex];
+
+            // 代/版本/类型/父节点都没变的槽位直接复用, 值的比特不需要重新序列化
+            if (const FDaxIrisSlot* PrevSlot = FDaxIrisState::GetSlot(PrevChunk, LocalIndex)) {
+                if (PrevSlot->Generation == Meta->Generations[LocalIndex] && PrevSlot->Version == Meta->Versions[LocalIndex] &&
+                    PrevSlot->Type == Type && PrevSlot->Parent == Meta->Parent[LocalIndex]) {
+                    Chunk->Slots[LocalIndex] = PrevChunk->Slots[LocalIndex];
+                    continue;
+                }
+            }
+
+            TSharedPtr<FDaxIrisSlot> Slot = MakeShared<FDaxIrisSlot>();
+            Slot->Generation = Meta->Generations[LocalIndex];
+            Slot->Version = Meta->Versions[LocalIndex];
+            Slot->Parent = Meta->Parent[LocalIndex];
+            Slot->Type = Type;
+            FDaxNode* Node = Allocator.TryGetNode(FDaxIrisState::MakeID(ci, LocalIndex, Slot->Generation));
+            if (!Node) {
+                Slot->Type = FDaxFakeTypeEmpty::StaticStruct();
+            }
+            else if (const auto* Arr = Node->GetArray()) {
+                Slot->Children = *Arr;
+            }
+            else if (const FDaxMapType* Map = Node->GetMap()) {
+                Slot->Entries.Reserve(static_cast<int32>(Map->size()));
+                for (const auto& KV : *Map) Slot->Entries.Emplace(KV.first, KV.second);
+            }
+            else if (Node->IsValue() && !IsIrisSerializableType(Type)) {
+                Slot->Type = FDaxFakeTypeEmpty::StaticStruct();
+            }
+            else if (Node->IsValue()) {
+                FBitWriter ValueWriter(0, true);
+                Node->SerializeValueData(ValueWriter, nullptr, Type);
+                Slot->Payload.Append(ValueWriter.GetData(), ValueWriter.GetNumBytes());
+                Slot->PayloadBits = static_cast<uint32>(ValueWriter.GetNumBits());
+            }
+            Chunk->Slots[LocalIndex] = Slot;
+        }
+        State->Chunks[ci] = Chunk;
+    }
+
+    IrisQuantizedState = State;
+    return IrisQuantizedState;
+}
+
+void FDaxSet::Iris_Apply(const FDaxIrisState& State) {
+    const FDaxIrisState* Prev = IrisAppliedState.GetReference();
+    if (Prev == &State) return;
+    bRunningOnServer = false;
+    PrepareOldValueCapture();
+    if (!Prev) {
+        Allocator.Reset();
+        RootID = {};
+    }
+
+    bool bStructChanged = false;
+    bool bDataChanged = false;
+    TArray<FDaxNodeID> Touched;
+
+    // 先释放所有消失或换代的槽位, 再新增/更新, 避免同一下标的新旧节点互相覆盖
+    const int32 PrevChunkCount = Prev ? Prev->Chunks.Num() : 0;
+    for (int32 ci = 0; ci < PrevChunkCount; ++ci) {
+        const FDaxIrisChunk* OldChunk = Prev->GetChunk(ci);
+        const FDaxIrisChunk* NewChunk = State.GetChunk(ci);
+        if (!OldChunk || OldChunk == NewChunk) continue;
+        uint32 Mask = OldChunk->UsedMask;
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            const FDaxIrisSlot* OldSlot = FDaxIrisState::GetSlot(OldChunk, LocalIndex);
+            const FDaxIrisSlot* NewSlot = FDaxIrisState::GetSlot(NewChunk, LocalIndex);
+            if (!OldSlot || (NewSlot && NewSlot->Generation == OldSlot->Generation)) continue;
+            const FDaxNodeID ID = FDaxIrisState::MakeID(ci, LocalIndex, OldSlot->Generation);
+            CaptureOldValue(ID);
+            MarkFrameChanged(ID, EDaxChangeKind::Removed);
+            Allocator.Deallocate(ID);
+            Touched.Add(ID);
+            bStructChanged = true;
+        }
+    }
+
+    for (int32 ci = 0; ci < State.Chunks.Num(); ++ci) {
+        const FDaxIrisChunk* OldChunk = Prev ? Prev->GetChunk(ci) : nullptr;
+        const FDaxIrisChunk* NewChunk = State.GetChunk(ci);
+        if (!NewChunk || OldChunk == NewChunk) continue;
+        uint32 Mask = NewChunk->UsedMask;
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            const FDaxIrisSlot* NewSlot = FDaxIrisState::GetSlot(NewChunk, LocalIndex);
+            const FDaxIrisSlot* OldSlot = FDaxIrisState::GetSlot(OldChunk, LocalIndex);
+            if (!NewSlot || NewSlot == OldSlot) continue;
+            if (OldSlot && OldSlot->Generation != NewSlot->Generation) OldSlot = nullptr;
+            const FDaxNodeID ID = FDaxIrisState::MakeID(ci, LocalIndex, NewSlot->Generation);
+            CaptureOldValue(ID);
+            Iris_ApplySlot(ID, *NewSlot, OldSlot, bStructChanged);
+            MarkFrameChanged(ID, OldSlot ? EDaxChangeKind::Value : EDaxChangeKind::Added);
+            Touched.Add(ID);
+            bDataChanged = true;
+        }
+    }
+
+    IrisAppliedState = &State;
+    ClientPredictionWatermark = State.PredictionWatermark;
+    if (!OverlayMap.empty()) ReconcilePredictions(&Touched);
+    if (bStructChanged) {
+        ++StructVersion;
+        ++DataVersion;
+    }
+    else if (bDataChanged) { ++DataVersion; }
+}
+
+void FDaxSet::Iris_ApplySlot(const FDaxNodeID ID, const FDaxIrisSlot& Slot, const FDaxIrisSlot* OldSlot, bool& bOutStructChanged) {
+    Allocator.AllocateSlotAt(ID);
+    if (FDaxNodeID* ParentRef = Allocator.GetParentRef(ID)) *ParentRef = Slot.Parent;
+    if (!Slot.Parent.IsValid()) RootID = ID;
+    if (!OldSlot || OldSlot->Type != Slot.Type || !(OldSlot->Parent == Slot.Parent)) bOutStructChanged = true;
+
+    FDaxNode* Node = Allocator.TryGetNode(ID);
+    if (!Node) return;
+    const UScriptStruct* Type = Slot.Type;
+    if (!Type || Type == FDaxFakeTypeEmpty::StaticStruct()) {
+        Node->ResetToEmpty();
+        Allocator.UpdateValueType(ID, FDaxFakeTypeEmpty::StaticStruct());
+    }
+    else if (Type == FDaxFakeTypeArray::StaticStruct()) {
+        if (!Node->IsArray()) Node->ResetToEmptyArray();
+        if (auto* Arr = Node->GetArray()) {
+            Arr->Reset();
+            Arr->Append(Slot.Children);
+            for (int32 i = 0; i < Arr->Num(); ++i) {
+                if ((*Arr)[i].IsValid()) Allocator.UpdateParentEdgeArray((*Arr)[i], static_cast<uint16>(i));
+            }
+        }
+        Allocator.UpdateValueType(ID, Type);
+        bOutStructChanged = true;
+    }
+    else if (Type == FDaxFakeTypeMap::StaticStruct()) {
+        if (!Node->IsMap()) Node->ResetToEmptyMap();
+        if (FDaxMapType* Map = Node->GetMap()) {
+            Map->clear();
+            for (const TPair<FName, FDaxNodeID>& Entry : Slot.Entries) {
+                (*Map)[Entry.Key] = Entry.Value;
+                Allocator.UpdateParentEdgeMap(Entry.Value, Entry.Key);
+            }
+        }
+        Allocator.UpdateValueType(ID, Type);
+        bOutStructChanged = true;
+    }
+    else {
+        FBitReader ValueReader(const_cast<uint8*>(Slot.Payload.GetData()), Slot.PayloadBits);
+        Node->SerializeValueData(ValueReader, nullptr, Type);
+        Allocator.UpdateValueType(ID, Type);
+    }
+}
+
+bool FDaxSet::Sync_ServerFullWrite(FNetDeltaSerializeInfo& DeltaParms) {
+    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerFullWrite"));
+    
+    FBitWriter& OutWriter = *DeltaParms.Writer;
+    TSharedPtr<FDaxSetBaseState> NewState = MakeShared<FDaxSetBaseState>();
+    *DeltaParms.NewState = NewState;
+
+    OutWriter.WriteBit(true);
+    OutWriter.WriteBit(false); // 一次性全量, 不分帧
+    OutWriter.WriteBit(false); // 常规全量格式
+
+    // 节点数达到阈值时正文先写入临时 Writer, 写完后整体压缩
+    const int32 CompressNodes = CVarDaxNetFullSyncCompressNodes.GetValueOnAnyThread();
+    const bool bTryCompress = CompressNodes > 0 && GetNodeNum() >= static_cast<uint32>(CompressNodes);
+    FNetBitWriter BodyWriter(DeltaParms.Map, 0);
+    if (!bTryCompress) OutWriter.WriteBit(false);
+    FBitWriter& Writer = bTryCompress ? BodyWriter : OutWriter;
+
+    FDaxNetFilter Filter;
+    BuildNetFilter(DeltaParms.Map, Filter);
+
+    NewState->ContainerVersion = DataVersion;
+    NewState->ChunkEpoch = Allocator.GetChangeEpoch();
+    NewState->NetConditionSerial = NetConditionSerial;
+    NewState->bOwnerConnection = Filter.bOwnerConnection;
+    NewState->Snapshot = AcquireNetSnapshot();
+    if (!Filter.IsEmpty()) {
+        NewState->Snapshot = NewState->Snapshot->MakeMasked(Filter.HiddenNodes.Array(), Filter.HiddenRoots.Array(), FDaxFakeTypeEmpty::StaticStruct());
+    }
+
+    uint32 NodeCount = GetNodeNum() - Filter.HiddenNodes.Num();
+    Writer.SerializeIntPacked(NodeCount);
+
+    FDaxNetTypeWriter TypeTable(nullptr, FDaxNetTypeCodec::MaxUserTypes); // 全量同步重新开始类型表与键名表
+    FDaxNetKeyWriter KeyTable(nullptr, FDaxNetKeyCodec::MaxKeys);
+
+    Allocator.ForEachNode([&](FDaxNodeID NodeID, FDaxNode& Node, uint32 Version, FDaxNodeID Parent,
+                              const UScriptStruct* Type) {
+        if (Filter.IsExcluded(NodeID)) return;
+        if (Filter.IsHiddenRoot(NodeID)) Type = FDaxFakeTypeEmpty::StaticStruct();
+        Writer << NodeID;
+        Writer << Parent;
+        FDaxNetTypeCodec::Write(Writer, DeltaParms.Map, Type, TypeTable);
+
+        if (Type == nullptr || Type == FDaxFakeTypeEmpty::StaticStruct()) {
+            
+        }
+        else if (Type == FDaxFakeTypeArray::StaticStruct()) {
+            auto* Arr = Node.GetArray();
+            uint32 Count = Arr ? static_cast<uint32>(Arr->Num()) : 0;
+            Writer.SerializeIntPacked(Count);
+            for (uint32 i = 0; i < Count; ++i) {
+                Writer << (*Arr)[i];
+            }
+        }
+        else if (Type == FDaxFakeTypeMap::StaticStruct()) {
+            auto* Map = Node.GetMap();
+            uint32 Count = Map ? static_cast<uint32>(Map->size()) : 0;
+            Writer.SerializeIntPacked(Count);
+            if (Map) {
+                for (auto& Kv : *Map) {
+                    FDaxNetKeyCodec::Write(Writer, Kv.first, KeyTable);
+                    Writer << Kv.second;
+                }
+            }
+        }
+        else {
+            Node.SerializeValueData(Writer, DeltaParms.Map, Type);
+        }
+    });
+    NewState->TypeTable = TypeTable.Finish();
+    NewState->KeyTable = KeyTable.Finish();
+
+    if (bTryCompress) {
+        FBitWriterMark CompressedMark(OutWriter);
+        OutWriter.WriteBit(true);
+        if (!WriteCompressedBody(OutWriter, BodyWriter)) {
+            // 压缩没有收益: 回退压缩标记, 改发原始比特
+            CompressedMark.Pop(OutWriter);
+            OutWriter.WriteBit(false);
+            OutWriter.SerializeBits(BodyWriter.GetData(), BodyWriter.GetNumBits());
+        }
+        DAX_NET_SYNC_LOG(Warning, "Full sync body {0} bits -> {1} bits", BodyWriter.GetNumBits(), OutWriter.GetNumBits() - CompressedMark.GetNumBits());
+    }
+    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerFullWrite End"));
+    return true;
+}
+
+bool FDaxSet::Sync_ServerDeltaWrite(FNetDeltaSerializeInfo& DeltaParms, FDaxSetBaseState* OldState, const bool bBeginHydration) {
+    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerDeltaWrite"));
+    FBitWriter& OutWriter = *DeltaParms.Writer;
+    if (bBeginHydration) {
+        OutWriter.WriteBit(true);
+        OutWriter.WriteBit(true); // 分帧水合的第一帧: 客户端清空后按增量读取
+    }
+    else {
+        OutWriter.WriteBit(false); // Delta Sync
+    }
+
+    const TSharedPtr<const FDaxSetSnapshot> NewSnapshot = AcquireNetSnapshot();
+    const FDaxSetSnapshot* OldSnapshot = OldState->Snapshot.Get();
+    int32 OutPacketId = 0;
+    int32 AckedPacketId = 0;
+    GetNetPacketWindow(DeltaParms, OutPacketId, AckedPacketId);
+    FDaxNetTypeWriter TypeTable(OldState->TypeTable, FDaxNetTypeCodec::MaxUserTypes, OutPacketId, AckedPacketId);
+    FDaxNetKeyWriter KeyTable(OldState->KeyTable, FDaxNetKeyCodec::MaxKeys, OutPacketId, AckedPacketId);
+
+    const int32 CurrChunkCount = static_cast<int32>(Allocator.GetChunkCount());
+    const int32 OldChunkCount = OldSnapshot->GetChunkCount();
+
+    // 该连接的子树过滤: 基线快照已按上次的过滤结果处理, 这里按当前结果比较
+    FDaxNetFilter Filter;
+    BuildNetFilter(DeltaParms.Map, Filter);
+    auto GetVisibleType = [&](const FDaxNodeID ID, const UScriptStruct* Type) -> const UScriptStruct* {
+        return Filter.IsHiddenRoot(ID) ? FDaxFakeTypeEmpty::StaticStruct() : Type;
+    };
+
+    struct FAddRec {
+        FDaxNodeID ID;
+        uint32 Version;
+        FDaxNodeID Parent;
+        const UScriptStruct* Type;
+    };
+    struct FUpdRec {
+        FDaxNodeID ID;
+        uint32 Version;
+        FDaxNodeID Parent;
+        const UScriptStruct* Type;
+    };
+    TArray<FDaxNodeID> Removes;
+    TArray<FAddRec> Adds;
+    TArray<FUpdRec> Updates;
+
+    // 限频子树: 间隔未到的纯值更新记为 Stale, 基线保留旧版本, 到期后与之后的修改合并成一次发送
+    const double Now = FPlatformTime::Seconds();
+    TArray<FDaxNodeID> Stale;
+    TMap<FDaxNodeID, double> NextSendTimes;
+    TSet<FDaxNodeID> OpenedRoots; // 本次写入已放行的子树, 同一子树的其他更新一并发送
+    double NextStaleSendTime = TNumericLimits<double>::Max();
+    if (!NetUpdateIntervals.IsEmpty()) {
+        for (const auto& KV : OldState->NextSendTimes) {
+            if (NetUpdateIntervals.Contains(KV.Key)) NextSendTimes.Add(KV.Key, KV.Value);
+        }
+    }
+    auto DeferThrottled = [&](const FDaxNodeID ID, const bool bValueOnly) {
+        FDaxNodeID ThrottleRoot;
+        const float Interval = bBeginHydration ? 0.f : GetNetUpdateInterval(ID, ThrottleRoot);
+        if (Interval <= 0.f || OpenedRoots.Contains(ThrottleRoot)) return false;
+        double& NextSend = NextSendTimes.FindOrAdd(ThrottleRoot, 0.0);
+        if (Now >= NextSend) {
+            OpenedRoots.Add(ThrottleRoot);
+            NextSend = Now + Interval;
+            return false;
+        }
+        if (!bValueOnly) return false; // 结构变化不延后, 也不占用间隔
+        NextStaleSendTime = FMath::Min(NextStaleSendTime, NextSend);
+        return true;
+    };
+
+    auto WriteFullArray = [&](FArchive& Ar, const FDaxNodeID ID) {
+        auto* Node = Allocator.TryGetNode(ID);
+        auto* Arr = Node ? Node->GetArray() : nullptr;
+        uint32 Count = Arr ? static_cast<uint32>(Arr->Num()) : 0;
+        Ar.SerializeIntPacked(Count);
+        for (uint32 i = 0; i < Count; ++i) Ar << (*Arr)[i];
+    };
+    
+    auto WriteFullMap = [&](FArchive& Ar, const FDaxNodeID ID) {
+        auto* Node = Allocator.TryGetNode(ID);
+        auto* Map = Node ? Node->GetMap() : nullptr;
+        uint32 Count = Map ? static_cast<uint32>(Map->size()) : 0;
+        Ar.SerializeIntPacked(Count);
+        if (Map)
+            for (auto& Kv : *Map) {
+                FDaxNetKeyCodec::Write(Ar, Kv.first, KeyTable);
+                Ar << Kv.second;
+            }
+    };
+    
+    auto WriteMapDelta = [&](FArchive& Ar, const FDaxNodeID ID, const FDaxSetSnapshot* Old) {
+        TArray<FName> RemovesKeys;
+        TArray<std::pair<FName, FDaxNodeID>> AddPairs;
+        TArray<std::pair<FName, FDaxNodeID>> RebindPairs;
+        const FDaxMapType* OldMap = Old->FindMap(ID);
+        auto* Node = Allocator.TryGetNode(ID);
+        auto* NewMap = Node ? Node->GetMap() : nullptr;
+        if (OldMap) {
+            for (const auto& KV : *OldMap) {
+                const FName K = KV.first;
+                const FDaxNodeID OldChild = KV.second;
+                if (!NewMap || NewMap->find(K) == NewMap->end()) RemovesKeys.Add(K);
+                else {
+                    const FDaxNodeID NewChild = NewMap->at(K);
+                    if (!(NewChild == OldChild)) RebindPairs.Emplace(K, NewChild);
+                }
+            }
+        }
+        if (NewMap) {
+            for (const auto& KV : *NewMap) {
+                const FName K = KV.first;
+                if (!OldMap || OldMap->find(K) == OldMap->end()) AddPairs.Emplace(K, KV.second);
+            }
+        }
+        uint32 Rm = RemovesKeys.Num();
+        uint32 Ad = static_cast<uint32>(AddPairs.Num());
+        uint32 Rb = static_cast<uint32>(RebindPairs.Num());
+        Ar.SerializeIntPacked(Rm);
+        Ar.SerializeIntPacked(Ad);
+        Ar.SerializeIntPacked(Rb);
+        for (const auto& K : RemovesKeys) FDaxNetKeyCodec::Write(Ar, K, KeyTable);
+        for (const auto& P : AddPairs) {
+            FDaxNetKeyCodec::Write(Ar, P.first, KeyTable);
+            Ar << const_cast<FDaxNodeID&>(P.second);
+        }
+        for (const auto& P : RebindPairs) {
+            FDaxNetKeyCodec::Write(Ar, P.first, KeyTable);
+            Ar << const_cast<FDaxNodeID&>(P.second);
+        }
+        return Rm + Ad + Rb;
+    };
+    
+    // 数组增量: 0 = 编辑脚本, 1 = 清空
+    auto WriteArrayDelta = [&](FArchive& Ar, const FDaxNodeID ID, const FDaxArrayEditScript& Script) {
+        auto* Node = Allocator.TryGetNode(ID);
+        auto* NewArr = Node ? Node->GetArray() : nullptr;
+        uint8 kind = (!NewArr || NewArr->IsEmpty()) ? 1 : 0;
+        Ar << kind;
+        if (kind == 0) FDaxArrayDiff::Write(Ar, Script);
+        return 1u;
+    };
+
+    auto DiffSlot = [&](const uint16 ChunkIndex, const uint16 LocalIndex, const FDaxNodeChunkMeta* OldMeta, const FDaxNodeChunkMeta* NewMeta) {
+        const uint32 CurrentBit = (1u << LocalIndex);
+        const bool bInNew = NewMeta && (NewMeta->UsedMask & CurrentBit) != 0;
+        const bool bInOld = OldMeta && (OldMeta->UsedMask & CurrentBit) != 0;
+        const uint16 GlobalIndex = static_cast<uint16>((ChunkIndex << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex);
+        if (bInNew && bInOld) {
+            const uint16 OldGen = OldMeta->Generations[LocalIndex];
+            const uint16 NewGen = NewMeta->Generations[LocalIndex];
+            const FDaxNodeID OldID(GlobalIndex, OldGen);
+            const FDaxNodeID NewID(GlobalIndex, NewGen);
+            if (!(OldID == NewID)) {
+                Removes.Add(OldID);
+                if (!Filter.IsExcluded(NewID)) {
+                    Adds.Add(FAddRec{
+                        NewID, NewMeta->Versions[LocalIndex], NewMeta->Parent[LocalIndex],
+                        GetVisibleType(NewID, NewMeta->ValueType[LocalIndex])
+                    });
+                }
+            }
+            else if (Filter.IsExcluded(NewID)) {
+                Removes.Add(OldID); // 基线里可见, 现在被过滤
+            }
+            else {
+                const UScriptStruct* NewType = GetVisibleType(NewID, NewMeta->ValueType[LocalIndex]);
+                bool bChanged = false;
+                if (!Filter.IsHiddenRoot(NewID)) bChanged |= (OldMeta->Versions[LocalIndex] != NewMeta->Versions[LocalIndex]);
+                bChanged |= !(OldMeta->Parent[LocalIndex] == NewMeta->Parent[LocalIndex]);
+                bChanged |= (OldMeta->ValueType[LocalIndex] != NewType);
+                if (!bChanged) return;
+                const bool bValueOnly = OldMeta->Parent[LocalIndex] == NewMeta->Parent[LocalIndex] && OldMeta->ValueType[LocalIndex] == NewType &&
+                    NewType && NewType != FDaxFakeTypeEmpty::StaticStruct() && NewType != FDaxFakeTypeArray::StaticStruct() && NewType != FDaxFakeTypeMap::StaticStruct();
+                if (!NetUpdateIntervals.IsEmpty() && DeferThrottled(NewID, bValueOnly)) {
+                    Stale.Add(NewID);
+                    return;
+                }
+                Updates.Add(FUpdRec{
+                    NewID, NewMeta->Versions[LocalIndex], NewMeta->Parent[LocalIndex],
+                    NewType
+                });
+            }
+        }
+        else if (!bInNew && bInOld) {
+            const uint16 OldGen = OldMeta->Generations[LocalIndex];
+            Removes.Add(FDaxNodeID(GlobalIndex, OldGen));
+        }
+        else if (bInNew && !bInOld) {
+            const FDaxNodeID NewID(GlobalIndex, NewMeta->Generations[LocalIndex]);
+            if (Filter.IsExcluded(NewID)) return;
+            Adds.Add(FAddRec{
+                NewID, NewMeta->Versions[LocalIndex], NewMeta->Parent[LocalIndex],
+                GetVisibleType(NewID, NewMeta->ValueType[LocalIndex])
+            });
+        }
+    };
+
+    // 连接确认的版本仍在变更日志范围内: 只比较日志里触达过的槽位, 开销与变化量成正比
+    // 基线是部分快照(水合未完成)时, 延后的节点不在日志和块 Epoch 的范围内, 需要比较所有与基线不同的块
+    // 同步条件变化时, 没有数据变化的块也可能需要增删节点, 因此逐块比较且不走共享/相同块的捷径
+    const bool bConditionsChanged = !bBeginHydration && (OldState->NetConditionSerial != NetConditionSerial || OldState->bOwnerConnection != Filter.bOwnerConnection);
+    const bool bPartialBase = bBeginHydration || bConditionsChanged || OldState->PendingNodes > 0;
+    TArray<uint16, TInlineAllocator<64>> TouchedIndices;
+    const bool bReplayChangeLog = !bPartialBase && ChangeLog.ForEachSince(OldState->ContainerVersion, [&](const FDaxChangeLogEntry& Entry) {
+        TouchedIndices.Add(Entry.ID.Index);
+    });
+
+    if (bReplayChangeLog) {
+        // 上次延后的节点早于确认版本, 不在日志的重放范围内
+        for (const FDaxNodeID ID : OldState->StaleNodes) TouchedIndices.Add(ID.Index);
+        TouchedIndices.Sort();
+        int32 PrevIndex = -1;
+        for (const uint16 GlobalIndex : TouchedIndices) {
+            if (GlobalIndex == PrevIndex) continue;
+            PrevIndex = GlobalIndex;
+            const uint16 ChunkIndex = static_cast<uint16>(GlobalIndex >> DAX_NODE_POOR_CHUNK_SHIFT);
+            const uint16 LocalIndex = static_cast<uint16>(GlobalIndex & DAX_NODE_POOR_CHUNK_MASK);
+            DiffSlot(ChunkIndex, LocalIndex, OldSnapshot->GetChunkMeta(ChunkIndex), Allocator.GetChunkMetadata(ChunkIndex));
+        }
+    }
+    else {
+        // 回退: 连接早于日志覆盖范围, 比较自该连接基线以来 Epoch 前进过的块, 加上基线里有而现在已不存在的块
+        TArray<uint16, TInlineAllocator<32>> ChunksToDiff;
+        Allocator.ForEachChunkChangedSince(bPartialBase ? 0 : OldState->ChunkEpoch, [&](const uint16 ChunkIndex) {
+            if (!bConditionsChanged && OldSnapshot->GetChunk(ChunkIndex) == NewSnapshot->GetChunk(ChunkIndex)) return; // 两个版本共享同一块快照
+            ChunksToDiff.Add(ChunkIndex);
+        });
+        for (int32 ci = CurrChunkCount; ci < OldChunkCount; ++ci) {
+            ChunksToDiff.Add(static_cast<uint16>(ci));
+        }
+        for (const FDaxNodeID ID : OldState->StaleNodes) ChunksToDiff.AddUnique(static_cast<uint16>(ID.Index >> DAX_NODE_POOR_CHUNK_SHIFT));
+
+        for (const uint16 ChunkIndex : ChunksToDiff) {
+            const auto OldMeta = OldSnapshot->GetChunkMeta(ChunkIndex);
+            const auto NewMeta = Allocator.GetChunkMetadata(ChunkIndex);
+            const uint32 MainUsedMask = NewMeta ? NewMeta->UsedMask : 0;
+            const uint32 OldUsedMask = OldMeta ? OldMeta->UsedMask : 0;
+            if (MainUsedMask == 0 && OldUsedMask == 0) continue;
+            if (OldMeta && NewMeta && !bConditionsChanged) {
+                if (OldUsedMask == MainUsedMask) {
+                    if (memcmp(OldMeta->Generations, NewMeta->Generations, sizeof(NewMeta->Generations)) == 0 &&
+                        memcmp(OldMeta->Versions, NewMeta->Versions, sizeof(NewMeta->Versions)) == 0 &&
+                        memcmp(OldMeta->Parent, NewMeta->Parent, sizeof(NewMeta->Parent)) == 0 &&
+                        memcmp(OldMeta->ValueType, NewMeta->ValueType, sizeof(NewMeta->ValueType)) == 0) {
+                        continue;
+                    }
+                }
+            }
+            uint32 CombineMask = MainUsedMask | OldUsedMask;
+            while (CombineMask) {
+                const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(CombineMask));
+                DiffSlot(ChunkIndex, LocalIndex, OldMeta, NewMeta);
+                CombineMask &= ~(1u << LocalIndex);
+            }
+        }
+    }
+
+    // 三个列表按下标升序写出, 配合 FDaxNodeIDListCodec 的间隔编码
+    Removes.Sort([](const FDaxNodeID A, const FDaxNodeID B) { return A.Index < B.Index; });
+    Updates.Sort([](const FUpdRec& A, const FUpdRec& B) { return A.ID.Index < B.ID.Index; });
+
+    // 新增节点受每连接字节预算限制: 按 用户优先级 > 浅层优先 > 下标 排序, 超出预算的留到之后的帧.
+    // 延后的节点连同排序键保存在基线里, 之后每帧只对新出现的新增节点求键排序, 再与上一帧留下的有序列表归并
+    const int32 AddBudgetBytes = CVarDaxNetHydrationBudgetBytes.GetValueOnAnyThread();
+    TArray<FDaxNetPendingAdd> AddKeys; // 与排序后的 Adds 一一对应, 只在有预算时生成
+    if (AddBudgetBytes > 0 && !Adds.IsEmpty()) {
+        TMap<FDaxNodeID, int32> AddIndices;
+        AddIndices.Reserve(Adds.Num());
+        for (int32 i = 0; i < Adds.Num(); ++i) AddIndices.Add(Adds[i].ID, i);
+
+        TBitArray<> Carried(false, Adds.Num());
+        TArray<FDaxNetPendingAdd> CarriedKeys;
+        CarriedKeys.Reserve(OldState->PendingAdds.Num());
+        for (const FDaxNetPendingAdd& Pending : OldState->PendingAdds) {
+            const int32* Found = AddIndices.Find(Pending.ID);
+            if (!Found) continue; // 延后期间已被移除或已被过滤
+            CarriedKeys.Add(Pending);
+            Carried[*Found] = true;
+        }
+        TArray<FDaxNetPendingAdd> FreshKeys;
+        FreshKeys.Reserve(Adds.Num() - CarriedKeys.Num());
+        for (int32 i = 0; i < Adds.Num(); ++i) {
+            if (Carried[i]) continue;
+            FDaxNetPendingAdd& Key = FreshKeys.AddDefaulted_GetRef();
+            Key.ID = Adds[i].ID;
+            Key.Priority = GetNetPriorityAndDepth(Key.ID, Key.Depth);
+        }
+        FreshKeys.Sort();
+
+        AddKeys.Reserve(Adds.Num());
+        int32 CarriedIt = 0;
+        int32 FreshIt = 0;
+        while (CarriedIt < CarriedKeys.Num() || FreshIt < FreshKeys.Num()) {
+            const bool bTakeFresh = CarriedIt >= CarriedKeys.Num() || (FreshIt < FreshKeys.Num() && FreshKeys[FreshIt] < CarriedKeys[CarriedIt]);
+            AddKeys.Add(bTakeFresh ? FreshKeys[FreshIt++] : CarriedKeys[CarriedIt++]);
+        }
+        TArray<FAddRec> OrderedAdds;
+        OrderedAdds.Reserve(Adds.Num());
+        for (const FDaxNetPendingAdd& Key : AddKeys) OrderedAdds.Add(Adds[AddIndices.FindChecked(Key.ID)]);
+        Adds = MoveTemp(OrderedAdds);
+    }
+    else {
+        Adds.Sort([](const FAddRec& A, const FAddRec& B) { return A.ID.Index < B.ID.Index; });
+    }
+
+    // 父节点还没有发出(本帧延后或排在后面)的新增节点一并延后, 客户端总是先收到父节点
+    TSet<FDaxNodeID> UnsentAdds;
+    if (!AddKeys.IsEmpty()) {
+        UnsentAdds.Reserve(Adds.Num());
+        for (const FAddRec& R : Adds) UnsentAdds.Add(R.ID);
+    }
+
+    // 新增记录先写入临时缓冲, 用于计算预算; 至少发送一条保证进度
+    FNetBitWriter AddWriter(DeltaParms.Map, 0);
+    int32 AddsSent = 0;
+    FDaxNodeIDListCodec AddIDs;
+    TArray<FDaxNetPendingAdd> DeferredAdds;
+    for (int32 AddIt = 0; AddIt < Adds.Num(); ++AddIt) {
+        const FAddRec& R = Adds[AddIt];
+        if (!AddKeys.IsEmpty()) {
+            const bool bOverBudget = AddsSent > 0 && AddWriter.GetNumBytes() >= AddBudgetBytes;
+            if (bOverBudget || UnsentAdds.Contains(R.Parent)) {
+                DeferredAdds.Add(AddKeys[AddIt]);
+                continue;
+            }
+            UnsentAdds.Remove(R.ID);
+        }
+        ++AddsSent;
+        const bool IsValueType = (R.Type && R.Type != FDaxFakeTypeEmpty::StaticStruct() && R.Type !=
+            FDaxFakeTypeArray::StaticStruct() && R.Type != FDaxFakeTypeMap::StaticStruct());
+        const bool IsContainer = (R.Type == FDaxFakeTypeArray::StaticStruct() || R.Type ==
+            FDaxFakeTypeMap::StaticStruct());
+        bool bSendValue = false;
+        if (IsValueType) {
+            if (auto* Node = Allocator.TryGetNode(R.ID)) {
+                if (Node->IsValue()) {
+                    auto SV = Node->TryGetValueGenericMutable();
+                    auto SS = SV.GetScriptStruct();
+                    bSendValue = (SS == R.Type);
+                }
+            }
+        }
+        const bool bSendCFull = IsContainer;
+        uint8 Flags = ArzDax::DaxMakeDeltaFlags(EDaxDeltaOp::Add, true, true, bSendValue, false, bSendCFull);
+        AddIDs.Write(AddWriter, R.ID);
+        AddWriter << Flags;
+        AddWriter << const_cast<FDaxNodeID&>(R.Parent);
+        FDaxNetTypeCodec::Write(AddWriter, DeltaParms.Map, R.Type, TypeTable);
+        if (bSendValue) {
+            if (auto* Node = Allocator.TryGetNode(R.ID)) Node->SerializeValueData(AddWriter, DeltaParms.Map, R.Type);
+        }
+        else if (bSendCFull) {
+            if (R.Type == FDaxFakeTypeArray::StaticStruct()) WriteFullArray(AddWriter, R.ID);
+            else if (R.Type == FDaxFakeTypeMap::StaticStruct()) WriteFullMap(AddWriter, R.ID);
+        }
+    }
+    // 水合批次与全量同步按同一阈值压缩, 正文先写入临时 Writer; 常规增量很小, 不压缩
+    const int32 CompressNodes = CVarDaxNetFullSyncCompressNodes.GetValueOnAnyThread();
+    const bool bTryCompress = (bBeginHydration || OldState->PendingNodes > 0) && CompressNodes > 0 && GetNodeNum() >= static_cast<uint32>(CompressNodes);
+    FNetBitWriter BodyWriter(DeltaParms.Map, 0);
+    if (!bTryCompress) OutWriter.WriteBit(false);
+    FBitWriter& Writer = bTryCompress ? BodyWriter : OutWriter;
+
+    uint8 bHydrating = DeferredAdds.IsEmpty() ? 0 : 1;
+    Writer.SerializeBits(&bHydrating, 1);
+    // 预测水位只在与基线不同时发送; 只有拥有者客户端会用它结算发出的预测
+    uint8 bWatermark = OldState->PredictionWatermark != ProcessedPredictionKey ? 1 : 0;
+    Writer.SerializeBits(&bWatermark, 1);
+    if (bWatermark) {
+        uint32 Watermark = ProcessedPredictionKey;
+        Writer.SerializeIntPacked(Watermark);
+    }
+    uint32 AddsCount = static_cast<uint32>(AddsSent);
+    uint32 RemovesCount = Removes.Num();
+    uint32 UpdatesCount = Updates.Num();
+    Writer.SerializeIntPacked(AddsCount);
+    Writer.SerializeIntPacked(RemovesCount);
+    Writer.SerializeIntPacked(UpdatesCount);
+
+    FDaxNodeIDListCodec RemoveIDs;
+    for (auto ID : Removes) { RemoveIDs.Write(Writer, ID); }
+    Writer.SerializeBits(AddWriter.GetData(), AddWriter.GetNumBits());
+
+    FDaxNodeIDListCodec UpdateIDs;
+    for (const auto& R : Updates) {
+        const uint16 ChunkIndex = static_cast<uint16>(R.ID.Index >> DAX_NODE_POOR_CHUNK_SHIFT);
+        const uint16 LocalIndex = static_cast<uint16>(R.ID.Index & DAX_NODE_POOR_CHUNK_MASK);
+        const auto* OldMeta = OldSnapshot->GetChunkMeta(ChunkIndex);
+        const auto* NewMeta = Allocator.GetChunkMetadata(ChunkIndex);
+        bool bParentChanged = false, bTypeChanged = false, bVersionChanged = false;
+        if (OldMeta && NewMeta) {
+            bParentChanged = !(OldMeta->Parent[LocalIndex] == NewMeta->Parent[LocalIndex]);
+            bTypeChanged = (OldMeta->ValueType[LocalIndex] != R.Type); // 被过滤的子树根按空节点比较
             bVersionChanged = (OldMeta->Versions[LocalIndex] != NewMeta->Versions[LocalIndex]);
         }
         const bool IsValueType = (R.Type && R.Type != FDaxFakeTypeEmpty::StaticStruct() && R.Type !=
@@ -1079,28 +2325,32 @@ bool FDaxSet::Sync_ServerDeltaWrite(FNetDeltaSerializeInfo& DeltaParms, FDaxSetB
         bool bSendParent = bParentChanged;
         bool bSendCDelta = false;
         bool bSendCFull = false;
+        FDaxArrayEditScript ArrayScript;
         if (IsArrayType) {
-            bool bHasOld = (OldState->ArrayMirror.find(R.ID) != OldState->ArrayMirror.end());
-            if (!bHasOld) bSendCFull = true;
+            const TArray<FDaxNodeID>* OldArr = OldSnapshot->FindArray(R.ID);
+            if (!OldArr) bSendCFull = true;
             else {
                 auto* Node = Allocator.TryGetNode(R.ID);
                 auto* Arr = Node ? Node->GetArray() : nullptr;
-                const int32 newN = Arr ? Arr->Num() : 0;
-                const int32 oldN = OldState->ArrayMirror[R.ID].Num();
-                const int32 approxChange = FMath::Abs(newN - oldN);
-                if (approxChange > FMath::Max(1, newN / 2)) bSendCFull = true;
-                else bSendCDelta = true;
+                const TConstArrayView<FDaxNodeID> NewView = Arr ? TConstArrayView<FDaxNodeID>(*Arr) : TConstArrayView<FDaxNodeID>();
+                if (NewView.IsEmpty()) bSendCDelta = !OldArr->IsEmpty();
+                else {
+                    // 按估算的字节数在编辑脚本和整表之间取较小者
+                    FDaxArrayDiff::Build(*OldArr, NewView, ArrayScript);
+                    if (ArrayScript.IsEmpty()) bSendCDelta = false;
+                    else if (FDaxArrayDiff::EstimateScriptBytes(ArrayScript) >= FDaxArrayDiff::EstimateFullBytes(NewView)) bSendCFull = true;
+                    else bSendCDelta = true;
+                }
             }
         }
         else if (IsMapType) {
-            bool bHasOld = (OldState->MapMirror.find(R.ID) != OldState->MapMirror.end());
-            if (!bHasOld) bSendCFull = true;
+            const FDaxMapType* OldMap = OldSnapshot->FindMap(R.ID);
+            if (!OldMap) bSendCFull = true;
             else {
-                const auto& OldMap = OldState->MapMirror[R.ID];
                 auto* Node = Allocator.TryGetNode(R.ID);
                 auto* Map = Node ? Node->GetMap() : nullptr;
                 const int32 newN = Map ? static_cast<int32>(Map->size()) : 0;
-                const int32 oldN = static_cast<int32>(OldMap.size());
+                const int32 oldN = static_cast<int32>(OldMap->size());
                 const int32 approxChange = FMath::Abs(newN - oldN);
                 if (approxChange > FMath::Max(1, newN / 2)) bSendCFull = true;
                 else bSendCDelta = true;
@@ -1116,17 +2366,32 @@ bool FDaxSet::Sync_ServerDeltaWrite(FNetDeltaSerializeInfo& DeltaParms, FDaxSetB
                 }
             }
         }
+        // 属性级增量: 类型未变且旧快照里有同类型影子时, 只发送变化的属性
+        bool bSendPropDelta = false;
+        TBitArray<> ChangedProperties;
+        if (bSendValue && !bTypeChanged && FDaxPropertyDelta::IsEnabled(R.Type)) {
+            const FInstancedStruct* Shadow = OldSnapshot->FindValue(R.ID);
+            const FDaxNode* NodePtr = Allocator.TryGetNode(R.ID);
+            if (Shadow && NodePtr && Shadow->GetScriptStruct() == R.Type) {
+                bSendPropDelta = FDaxPropertyDelta::BuildChangedMask(R.Type, Shadow->GetMemory(), NodePtr->TryGetValueGeneric().GetMemory(), ChangedProperties);
+            }
+        }
         bool bSendType = bTypeChanged || bSendValue || bSendCDelta || bSendCFull;
         uint8 Flags = ArzDax::DaxMakeDeltaFlags(EDaxDeltaOp::Update, bSendParent, bSendType, bSendValue, bSendCDelta,
                                                 bSendCFull);
-        Writer << const_cast<FDaxNodeID&>(R.ID);
+        if (bSendPropDelta) Flags |= ArzDax::DAX_DELTA_FLAG_PROPDELTA;
+        UpdateIDs.Write(Writer, R.ID);
         Writer << Flags;
         if (bSendParent) Writer << const_cast<FDaxNodeID&>(R.Parent);
         if (bSendType) {
-            UObject* TempTypeObject = const_cast<UScriptStruct*>(R.Type);
-            DeltaParms.Map->SerializeObject(Writer, UScriptStruct::StaticClass(), TempTypeObject);
+            FDaxNetTypeCodec::Write(Writer, DeltaParms.Map, R.Type, TypeTable);
         }
-        if (bSendValue) {
+        if (bSendPropDelta) {
+            if (auto* Node = Allocator.TryGetNode(R.ID)) {
+                FDaxPropertyDelta::Write(Writer, DeltaParms.Map, R.Type, Node->TryGetValueGenericMutable().GetMemory(), ChangedProperties);
+            }
+        }
+        else if (bSendValue) {
             if (auto* Node = Allocator.TryGetNode(R.ID)) {
                 TObjectPtr<const UScriptStruct> TempType = R.Type;
                 Node->SerializeValueData(Writer, DeltaParms.Map, TempType);
@@ -1137,80 +2402,94 @@ bool FDaxSet::Sync_ServerDeltaWrite(FNetDeltaSerializeInfo& DeltaParms, FDaxSetB
             else if (IsMapType) WriteFullMap(Writer, R.ID);
         }
         else if (bSendCDelta) {
-            if (IsArrayType) WriteArrayDelta(Writer, R.ID, OldState);
-            else if (IsMapType) WriteMapDelta(Writer, R.ID, OldState);
+            if (IsArrayType) WriteArrayDelta(Writer, R.ID, ArrayScript);
+            else if (IsMapType) WriteMapDelta(Writer, R.ID, OldSnapshot);
+        }
+    }
+
+    if (bTryCompress) {
+        FBitWriterMark CompressedMark(OutWriter);
+        OutWriter.WriteBit(true);
+        if (!WriteCompressedBody(OutWriter, BodyWriter)) {
+            CompressedMark.Pop(OutWriter);
+            OutWriter.WriteBit(false);
+            OutWriter.SerializeBits(BodyWriter.GetData(), BodyWriter.GetNumBits());
         }
+        DAX_NET_SYNC_LOG(Warning, "Hydration batch {0} bits -> {1} bits", BodyWriter.GetNumBits(), OutWriter.GetNumBits() - CompressedMark.GetNumBits());
     }
 
     TSharedPtr<FDaxSetBaseState> NewState = MakeShared<FDaxSetBaseState>();
     NewState->ContainerVersion = DataVersion;
-    for (int32 ci = 0; ci < CurrChunkCount; ++ci) {
-        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata((uint16)ci);
-        if (!Meta) continue;
-        auto Copy = MakeUnique<FDaxNodeChunkMeta>(*Meta);
-        NewState->ChildStates.Add(MoveTemp(Copy));
-    }
-    if (OldState) {
-        for (const auto& P : OldState->ArrayMirror) { NewState->ArrayMirror.emplace(P.first, P.second); }
-        for (const auto& P : OldState->MapMirror) { NewState->MapMirror.emplace(P.first, P.second); }
+    NewState->ChunkEpoch = Allocator.GetChangeEpoch();
+    // 延后的节点从基线里摘掉, 下次写入时它们仍然表现为新增; 被过滤的节点按该连接看到的样子记录
+    if (DeferredAdds.IsEmpty() && Filter.IsEmpty()) {
+        NewState->Snapshot = NewSnapshot;
     }
-    for (const auto& ID : Removes) {
-        NewState->ArrayMirror.erase(ID);
-        NewState->MapMirror.erase(ID);
+    else {
+        TArray<FDaxNodeID> RemovedSlots = Filter.HiddenNodes.Array();
+        for (const FDaxNetPendingAdd& Pending : DeferredAdds) RemovedSlots.Add(Pending.ID);
+        NewState->Snapshot = NewSnapshot->MakeMasked(RemovedSlots, Filter.HiddenRoots.Array(), FDaxFakeTypeEmpty::StaticStruct());
     }
-    auto RefreshContainerMirror = [&](const FDaxNodeID ID, const UScriptStruct* Type) {
-        if (Type == FDaxFakeTypeArray::StaticStruct()) {
-            if (auto* Node = Allocator.TryGetNode(ID)) {
-                if (auto* Arr = Node->GetArray()) { NewState->ArrayMirror[ID] = *Arr; }
-                else { NewState->ArrayMirror.erase(ID); }
-            }
-            NewState->MapMirror.erase(ID);
-        }
-        else if (Type == FDaxFakeTypeMap::StaticStruct()) {
-            if (auto* Node = Allocator.TryGetNode(ID)) {
-                if (auto* Map = Node->GetMap()) { NewState->MapMirror[ID] = *Map; }
-                else { NewState->MapMirror.erase(ID); }
-            }
-            NewState->ArrayMirror.erase(ID);
-        }
-        else {
-            NewState->ArrayMirror.erase(ID);
-            NewState->MapMirror.erase(ID);
-        }
-    };
-    for (const auto& R : Adds) RefreshContainerMirror(R.ID, R.Type);
-    for (const auto& R : Updates) RefreshContainerMirror(R.ID, R.Type);
+    if (!Stale.IsEmpty()) NewState->Snapshot = NewState->Snapshot->MakeStale(Stale, *OldSnapshot);
+    NewState->PendingNodes = static_cast<uint32>(DeferredAdds.Num());
+    NewState->PendingAdds = MoveTemp(DeferredAdds);
+    NewState->PredictionWatermark = ProcessedPredictionKey;
+    NewState->NetConditionSerial = NetConditionSerial;
+    NewState->bOwnerConnection = Filter.bOwnerConnection;
+    NewState->TypeTable = TypeTable.Finish();
+    NewState->KeyTable = KeyTable.Finish();
+    NewState->StaleNodes = MoveTemp(Stale);
+    NewState->NextSendTimes = MoveTemp(NextSendTimes);
+    NewState->NextStaleSendTime = NextStaleSendTime;
+    if (NewState->PendingNodes > 0 || !NewState->StaleNodes.IsEmpty()) bNetHydrationPending = true;
 
     *DeltaParms.NewState = NewState;
     DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerDeltaWrite End"));
     return true;
 }
 
-bool FDaxSet::Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms) {
+bool FDaxSet::Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms, const FDaxNetReadCursor* Resume) {
     DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ClientFullRead"));
     FBitReader& Reader = *DeltaParms.Reader;
 
-    Allocator.Reset();
-    OverlayMap.clear();
-    RootID = {};
+    // 键名下标未定义时 Reader 已被标记为错误, 调用方必须中止读取, 不能把子节点挂到 NAME_None 下
+    auto ReadMapKey = [&](FName& OutKey) { return FDaxNetKeyCodec::Read(Reader, ClientKeyTable, OutKey); };
 
     uint32 NodeCount = 0;
-    Reader.SerializeIntPacked(NodeCount);
     FDaxNodeID RootCandidate{};
+    if (Resume) { // 续读: 中断之前的节点已经写入, 从中断的记录继续
+        NodeCount = Resume->NodeCount;
+        RootCandidate = Resume->RootCandidate;
+    }
+    else {
+        // 预测保留到读取结束, 再与重建后的权威值逐个比较
+        Allocator.Reset();
+        RootID = {};
+        ClientTypeTable.Reset();
+        ClientKeyTable.Reset();
+        Reader.SerializeIntPacked(NodeCount);
+    }
 
-    for (uint32 i = 0; i < NodeCount; ++i) {
+    for (uint32 i = Resume ? Resume->Next : 0; i < NodeCount; ++i) {
+        const int64 RecordStart = Reader.GetPosBits();
         FDaxNodeID NodeID;
         Reader << NodeID;
         FDaxNodeID Parent;
         Reader << Parent;
-        UObject* TempTypeObject = nullptr;
-        const bool bTypeMapped = DeltaParms.Map->SerializeObject(Reader, UScriptStruct::StaticClass(), TempTypeObject);
-        if (!bTypeMapped) {
-            DAX_NET_SYNC_LOG(Warning, "FullSync: Unmapped UScriptStruct at node {0}. Defer reading.", NodeID.ToString());
+        const UScriptStruct* ReadType = nullptr;
+        if (!FDaxNetTypeCodec::Read(Reader, DeltaParms.Map, ClientTypeTable, ReadType)) {
+            if (Reader.IsError()) return false;
+            DAX_NET_SYNC_LOG(Warning, "FullSync: Unmapped UScriptStruct at node {0}. Stage the remaining records.", NodeID.ToString());
+            FDaxNetReadCursor Cursor;
+            Cursor.Kind = EDaxNetReadKind::Full;
+            Cursor.Next = i;
+            Cursor.NodeCount = NodeCount;
+            Cursor.RootCandidate = RootCandidate;
+            StagePendingNetRead(Reader, RecordStart, MoveTemp(Cursor));
             DeltaParms.bOutHasMoreUnmapped = true;
             return true;
         }
-        TObjectPtr<const UScriptStruct> TempType = Cast<UScriptStruct>(TempTypeObject);
+        TObjectPtr<const UScriptStruct> TempType = ReadType;
 
         Allocator.AllocateSlotAt(NodeID);
         if (auto InfoRef = Allocator.GetCommonInfoRef(NodeID); InfoRef.IsValid()) {
@@ -1255,7 +2534,7 @@ bool FDaxSet::Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms) {
                 for (uint32 k = 0; k < Count; ++k) {
                     FName K;
                     FDaxNodeID C;
-                    Reader << K;
+                    if (!ReadMapKey(K)) return false;
                     Reader << C;
                     (*Map)[K] = C;
                 }
@@ -1264,7 +2543,7 @@ bool FDaxSet::Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms) {
                 for (uint32 k = 0; k < Count; ++k) {
                     FName K;
                     FDaxNodeID Dummy;
-                    Reader << K;
+                    if (!ReadMapKey(K)) return false;
                     Reader << Dummy;
                 }
             }
@@ -1279,6 +2558,9 @@ bool FDaxSet::Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms) {
     }
 
     if (RootCandidate.IsValid()) RootID = RootCandidate;
+    ReconcilePredictions(nullptr);
+    bClientHydrating = false;
+    bClientHydratedEvent = true;
     ++StructVersion;
     ++DataVersion;
     DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ClientFullRead End"));
@@ -1286,66 +2568,490 @@ bool FDaxSet::Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms) {
     return true;
 }
 
-bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
+bool FDaxSet::Sync_ServerCheckpointWrite(FNetDeltaSerializeInfo& DeltaParms) {
+    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ServerCheckpointWrite"));
+
+    FBitWriter& Writer = *DeltaParms.Writer;
+    TSharedPtr<FDaxSetBaseState> NewState = MakeShared<FDaxSetBaseState>();
+    *DeltaParms.NewState = NewState;
+
+    Writer.WriteBit(true);
+    Writer.WriteBit(false);
+    Writer.WriteBit(true); // 检查点格式
+
+    FDaxNetFilter Filter;
+    BuildNetFilter(DeltaParms.Map, Filter);
+
+    NewState->ContainerVersion = DataVersion;
+    NewState->ChunkEpoch = Allocator.GetChangeEpoch();
+    NewState->NetConditionSerial = NetConditionSerial;
+    NewState->bOwnerConnection = Filter.bOwnerConnection;
+    NewState->Snapshot = AcquireNetSnapshot();
+    if (!Filter.IsEmpty()) {
+        NewState->Snapshot = NewState->Snapshot->MakeMasked(Filter.HiddenNodes.Array(), Filter.HiddenRoots.Array(), FDaxFakeTypeEmpty::StaticStruct());
+    }
+    // 字典留空, 之后的增量重新定义类型与键名(客户端读检查点时同样清空)
+
+    // 第一遍: 收集布局与类型/键名表, 每个类型只 SerializeObject 一次
+    const int32 ChunkCount = static_cast<int32>(Allocator.GetChunkCount());
+    TArray<uint32> Masks;
+    Masks.SetNumZeroed(ChunkCount);
+    TMap<const UScriptStruct*, uint32> TypeIndices;
+    TArray<const UScriptStruct*> Types;
+    TMap<FName, uint32> KeyIndices;
+    TArray<FName> Keys;
+    int32 UsedChunks = 0;
+    for (int32 ci = 0; ci < ChunkCount; ++ci) {
+        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(static_cast<uint16>(ci));
+        if (!Meta) continue;
+        uint32 Mask = Meta->UsedMask;
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            const FDaxNodeID ID(static_cast<uint16>((ci << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex), Meta->Generations[LocalIndex]);
+            if (Filter.IsExcluded(ID)) continue;
+            Masks[ci] |= 1u << LocalIndex;
+            UsedChunks = ci + 1;
+            if (Filter.IsHiddenRoot(ID)) continue;
+            const UScriptStruct* Type = Meta->ValueType[LocalIndex];
+            if (Type == FDaxFakeTypeMap::StaticStruct()) {
+                const FDaxNode* Node = Allocator.TryGetNode(ID);
+                if (const FDaxMapType* Map = Node ? Node->GetMap() : nullptr) {
+                    for (const auto& Kv : *Map) {
+                        if (!KeyIndices.Contains(Kv.first)) KeyIndices.Add(Kv.first, Keys.Add(Kv.first));
+                    }
+                }
+            }
+            else if (Type && Type != FDaxFakeTypeEmpty::StaticStruct() && Type != FDaxFakeTypeArray::StaticStruct()) {
+                if (!TypeIndices.Contains(Type)) TypeIndices.Add(Type, Types.Add(Type));
+            }
+        }
+    }
+
+    uint32 TypeCount = static_cast<uint32>(Types.Num());
+    Writer.SerializeIntPacked(TypeCount);
+    for (const UScriptStruct* Type : Types) {
+        UObject* TypeObject = const_cast<UScriptStruct*>(Type);
+        DeltaParms.Map->SerializeObject(Writer, UScriptStruct::StaticClass(), TypeObject);
+    }
+    uint32 KeyCount = static_cast<uint32>(Keys.Num());
+    Writer.SerializeIntPacked(KeyCount);
+    for (FName& Key : Keys) Writer << Key;
+
+    uint32 LayoutChunks = static_cast<uint32>(UsedChunks);
+    Writer.SerializeIntPacked(LayoutChunks);
+    for (int32 ci = 0; ci < UsedChunks; ++ci) {
+        Writer << Masks[ci];
+        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(static_cast<uint16>(ci));
+        uint32 Mask = Masks[ci];
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            uint16 Generation = Meta->Generations[LocalIndex];
+            Writer << Generation;
+        }
+    }
+
+    // 第二遍: 按布局顺序写节点内容, 节点 ID 由布局推出
+    for (int32 ci = 0; ci < UsedChunks; ++ci) {
+        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(static_cast<uint16>(ci));
+        uint32 Mask = Masks[ci];
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            const FDaxNodeID ID(static_cast<uint16>((ci << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex), Meta->Generations[LocalIndex]);
+            FDaxNodeID Parent = Meta->Parent[LocalIndex];
+            Writer.WriteBit(Parent.IsValid());
+            if (Parent.IsValid()) Writer << Parent;
+
+            const UScriptStruct* Type = Filter.IsHiddenRoot(ID) ? FDaxFakeTypeEmpty::StaticStruct() : Meta->ValueType[LocalIndex];
+            FDaxNode* Node = Allocator.TryGetNode(ID);
+            uint32 Kind = CheckpointKindValue;
+            if (!Node || Type == nullptr || Type == FDaxFakeTypeEmpty::StaticStruct()) Kind = CheckpointKindEmpty;
+            else if (Type == FDaxFakeTypeArray::StaticStruct()) Kind = CheckpointKindArray;
+            else if (Type == FDaxFakeTypeMap::StaticStruct()) Kind = CheckpointKindMap;
+            Writer.SerializeBits(&Kind, 2);
+
+            if (Kind == CheckpointKindArray) {
+                auto* Arr = Node->GetArray();
+                uint32 Count = Arr ? static_cast<uint32>(Arr->Num()) : 0;
+                Writer.SerializeIntPacked(Count);
+                for (uint32 i = 0; i < Count; ++i) Writer << (*Arr)[i];
+            }
+            else if (Kind == CheckpointKindMap) {
+                auto* Map = Node->GetMap();
+                uint32 Count = Map ? static_cast<uint32>(Map->size()) : 0;
+                Writer.SerializeIntPacked(Count);
+                if (Map) {
+                    for (auto& Kv : *Map) {
+                        uint32 KeyIndex = KeyIndices.FindChecked(Kv.first);
+                        Writer.SerializeIntPacked(KeyIndex);
+                        Writer << Kv.second;
+                    }
+                }
+            }
+            else if (Kind == CheckpointKindValue) {
+                uint32 TypeIndex = TypeIndices.FindChecked(Type);
+                Writer.SerializeIntPacked(TypeIndex);
+                Node->SerializeValueData(Writer, DeltaParms.Map, Type);
+            }
+        }
+    }
+    DAX_NET_SYNC_LOG(Warning, "Checkpoint: types={0} keys={1} chunks={2} bits={3}", TypeCount, KeyCount, LayoutChunks, Writer.GetNumBits());
+    return true;
+}
+
+bool FDaxSet::Sync_ClientCheckpointRead(FNetDeltaSerializeInfo& DeltaParms) {
+    DAX_NET_SYNC_LOG(Warning, TEXT("FDaxSet::Sync_ClientCheckpointRead"));
+    FBitReader& Reader = *DeltaParms.Reader;
+    const int64 CheckpointStart = Reader.GetPosBits();
+
+    // 头部的类型全部解析完才改动容器, 有未映射的类型时整体推迟, 容器保持上一份状态
+    uint32 TypeCount = 0;
+    Reader.SerializeIntPacked(TypeCount);
+    if (TypeCount > FDaxNetTypeCodec::MaxUserTypes) {
+        Reader.SetError();
+        return false;
+    }
+    TArray<const UScriptStruct*, TInlineAllocator<32>> Types;
+    bool bUnmapped = false;
+    for (uint32 i = 0; i < TypeCount; ++i) {
+        UObject* TypeObject = nullptr;
+        const bool bMapped = DeltaParms.Map->SerializeObject(Reader, UScriptStruct::StaticClass(), TypeObject);
+        const UScriptStruct* Type = Cast<UScriptStruct>(TypeObject);
+        if (!bMapped || !Type) bUnmapped = true;
+        Types.Add(Type);
+    }
+    if (Reader.IsError()) return false;
+    if (bUnmapped) {
+        DAX_NET_SYNC_LOG(Warning, TEXT("Checkpoint: Unmapped UScriptStruct. Stage the checkpoint."));
+        FDaxNetReadCursor Cursor;
+        Cursor.Kind = EDaxNetReadKind::Checkpoint;
+        StagePendingNetRead(Reader, CheckpointStart, MoveTemp(Cursor));
+        DeltaParms.bOutHasMoreUnmapped = true;
+        return true;
+    }
+
+    uint32 KeyCount = 0;
+    Reader.SerializeIntPacked(KeyCount);
+    if (KeyCount > FDaxAllocator::TotalCapacity) {
+        Reader.SetError();
+        return false;
+    }
+    TArray<FName> Keys;
+    Keys.SetNum(KeyCount);
+    for (uint32 i = 0; i < KeyCount; ++i) Reader << Keys[i];
+
+    uint32 LayoutChunks = 0;
+    Reader.SerializeIntPacked(LayoutChunks);
+    if (LayoutChunks > DAX_NODE_POOR_MAX_CHUNKS) {
+        Reader.SetError();
+        return false;
+    }
+    TArray<uint32> Masks;
+    Masks.SetNumZeroed(LayoutChunks);
+    TArray<uint16> Generations;
+    Generations.SetNumZeroed(LayoutChunks << DAX_NODE_POOR_CHUNK_SHIFT);
+    TArray<FDaxNodeID> Incoming;
+    for (uint32 ci = 0; ci < LayoutChunks; ++ci) {
+        Reader << Masks[ci];
+        uint32 Mask = Masks[ci];
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            const uint16 Index = static_cast<uint16>((ci << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex);
+            Reader << Generations[Index];
+            Incoming.Add(FDaxNodeID(Index, Generations[Index]));
+        }
+    }
+    if (Reader.IsError()) return false;
+
+    bool bStructChanged = false;
+    bool bDataChanged = false;
+    TArray<FDaxNodeID> ChangedContainers;
+
+    // 先释放检查点里不存在(或已换代)的本地节点
+    for (int32 ci = 0; ci < static_cast<int32>(Allocator.GetChunkCount()); ++ci) {
+        const FDaxNodeChunkMeta* Meta = Allocator.GetChunkMetadata(static_cast<uint16>(ci));
+        if (!Meta) continue;
+        const uint32 IncomingMask = ci < static_cast<int32>(LayoutChunks) ? Masks[ci] : 0;
+        uint32 Mask = Meta->UsedMask;
+        while (Mask) {
+            const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+            Mask &= ~(1u << LocalIndex);
+            const uint16 Index = static_cast<uint16>((ci << DAX_NODE_POOR_CHUNK_SHIFT) | LocalIndex);
+            const FDaxNodeID ID(Index, Meta->Generations[LocalIndex]);
+            if ((IncomingMask & (1u << LocalIndex)) && Generations[Index] == ID.Generation) continue;
+            CaptureOldValue(ID);
+            MarkFrameChanged(ID, EDaxChangeKind::Removed);
+            Allocator.Deallocate(ID);
+            bStructChanged = true;
+        }
+    }
+
+    // 再逐个节点与本地比较, 只有内容不同的节点才写入并记入本帧变更
+    FDaxNodeID RootCandidate{};
+    TArray<FDaxNodeID, TInlineAllocator<32>> Children;
+    TArray<TPair<FName, FDaxNodeID>, TInlineAllocator<32>> Entries;
+    for (const FDaxNodeID ID : Incoming) {
+        FDaxNodeID Parent{};
+        if (Reader.ReadBit()) Reader << Parent;
+        uint32 Kind = 0;
+        Reader.SerializeBits(&Kind, 2);
+        const UScriptStruct* Type = FDaxFakeTypeEmpty::StaticStruct();
+        if (Kind == CheckpointKindArray) Type = FDaxFakeTypeArray::StaticStruct();
+        else if (Kind == CheckpointKindMap) Type = FDaxFakeTypeMap::StaticStruct();
+        else if (Kind == CheckpointKindValue) {
+            uint32 TypeIndex = 0;
+            Reader.SerializeIntPacked(TypeIndex);
+            if (!Types.IsValidIndex(static_cast<int32>(TypeIndex))) {
+                Reader.SetError();
+                return false;
+            }
+            Type = Types[TypeIndex];
+        }
+
+        Children.Reset();
+        Entries.Reset();
+        if (Kind == CheckpointKindArray || Kind == CheckpointKindMap) {
+            uint32 Count = 0;
+            Reader.SerializeIntPacked(Count);
+            if (Count > FDaxAllocator::TotalCapacity) {
+                Reader.SetError();
+                return false;
+            }
+            for (uint32 k = 0; k < Count; ++k) {
+                FName Key = NAME_None;
+                if (Kind == CheckpointKindMap) {
+                    uint32 KeyIndex = 0;
+                    Reader.SerializeIntPacked(KeyIndex);
+                    if (!Keys.IsValidIndex(static_cast<int32>(KeyIndex))) {
+                        Reader.SetError();
+                        return false;
+                    }
+                    Key = Keys[KeyIndex];
+                }
+                FDaxNodeID Child;
+                Reader << Child;
+                if (Kind == CheckpointKindMap) Entries.Emplace(Key, Child);
+                else Children.Add(Child);
+            }
+        }
+        if (Reader.IsError()) return false;
+
+        const bool bExisted = Allocator.IsNodeValid(ID);
+        if (!bExisted) Allocator.AllocateSlotAt(ID);
+        FDaxNode* Node = Allocator.TryGetNode(ID);
+        if (!Node) {
+            if (Kind == CheckpointKindValue) FDaxNode::SkipValueData(Reader, DeltaParms.Map, Type);
+            continue;
+        }
+        if (!Parent.IsValid()) RootCandidate = ID;
+
+        bool bChanged = !bExisted || Allocator.GetValueType(ID) != Type;
+        if (FDaxNodeID* ParentRef = Allocator.GetParentRef(ID); ParentRef && !(*ParentRef == Parent)) {
+            *ParentRef = Parent;
+            bStructChanged = true;
+            bChanged = true;
+        }
+
+        if (Kind == CheckpointKindEmpty) {
+            if (!Node->IsEmpty()) {
+                CaptureOldValue(ID);
+                Node->ResetToEmpty();
+                bChanged = true;
+            }
+        }
+        else if (Kind == CheckpointKindArray) {
+            if (!Node->IsArray()) {
+                CaptureOldValue(ID);
+                Node->ResetToEmptyArray();
+            }
+            if (auto* Arr = Node->GetArray()) {
+                bool bSame = Arr->Num() == Children.Num();
+                for (int32 i = 0; bSame && i < Children.Num(); ++i) bSame = (*Arr)[i] == Children[i];
+                if (!bSame) {
+                    Arr->Reset();
+                    Arr->Append(Children);
+                    bChanged = true;
+                }
+            }
+        }
+        else if (Kind == CheckpointKindMap) {
+            if (!Node->IsMap()) {
+                CaptureOldValue(ID);
+                Node->ResetToEmptyMap();
+            }
+            if (FDaxMapType* Map = Node->GetMap()) {
+                bool bSame = Map->size() == static_cast<size_t>(Entries.Num());
+                for (int32 i = 0; bSame && i < Entries.Num(); ++i) {
+                    const auto It = Map->find(Entries[i].Key);
+                    bSame = It != Map->end() && It->second == Entries[i].Value;
+                }
+                if (!bSame) {
+                    Map->clear();
+                    for (const TPair<FName, FDaxNodeID>& Entry : Entries) (*Map)[Entry.Key] = Entry.Value;
+                    bChanged = true;
+                }
+            }
+        }
+        else if (Node->IsValue() && !bChanged) {
+            // 类型相同: 先读进临时值比较, 相同的值不产生变更通知
+            FStructView Current = Node->TryGetValueGenericMutable();
+            FDaxNode::WithScratchValue(Type, [&](void* Scratch) {
+                FDaxNode::SerializeValueMemory(Reader, DeltaParms.Map, Type, Scratch);
+                if (Type->CompareScriptStruct(Current.GetMemory(), Scratch, PPF_None)) return;
+                CaptureOldValue(ID);
+                Type->CopyScriptStruct(Current.GetMemory(), Scratch);
+                bChanged = true;
+            });
+        }
+        else {
+            CaptureOldValue(ID);
+            Node->SerializeValueData(Reader, DeltaParms.Map, Type);
+            bChanged = true;
+        }
+
+        if (!bChanged) continue;
+        Allocator.UpdateValueType(ID, Type);
+        if (Kind == CheckpointKindArray || Kind == CheckpointKindMap) {
+            ChangedContainers.Add(ID);
+            bStructChanged = true;
+        }
+        MarkFrameChanged(ID, bExisted ? EDaxChangeKind::Value : EDaxChangeKind::Added);
+        bDataChanged = true;
+    }
+    if (Reader.IsError()) return false;
+
+    // 子节点可能排在容器之后才分配, 父边在全部节点就位后统一更新
+    for (const FDaxNodeID ID : ChangedContainers) {
+        const FDaxNode* Node = Allocator.TryGetNode(ID);
+        if (const auto* Arr = Node ? Node->GetArray() : nullptr) {
+            for (int32 i = 0; i < Arr->Num(); ++i) {
+                if ((*Arr)[i].IsValid()) Allocator.UpdateParentEdgeArray((*Arr)[i], static_cast<uint16>(i));
+            }
+        }
+        else if (const FDaxMapType* Map = Node ? Node->GetMap() : nullptr) {
+            for (const auto& Kv : *Map) Allocator.UpdateParentEdgeMap(Kv.second, Kv.first);
+        }
+    }
+
+    if (RootCandidate.IsValid()) RootID = RootCandidate;
+    ClientTypeTable.Reset();
+    ClientKeyTable.Reset();
+    ReconcilePredictions(nullptr);
+    bClientHydrating = false;
+    bClientHydratedEvent = true;
+    if (bStructChanged) {
+        ++StructVersion;
+        ++DataVersion;
+    }
+    else if (bDataChanged) { ++DataVersion; }
+    DAX_NET_SYNC_LOG(Warning, "Checkpoint ReaderBits pos={0}/{1}", Reader.GetPosBits(), Reader.GetNumBits());
+    return true;
+}
+
+bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms, const FDaxNetReadCursor* Resume) {
     SCOPE_CYCLE_COUNTER(STAT_NetDeltaSync);
     DAX_NET_SYNC_LOG(Warning, "DaxSet::Sync_ClientDeltaRead");
     FBitReader& Reader = *DeltaParms.Reader;
-    OverlayMap.clear();
-
-    bool bLocalStructChanged = false;
-    bool bLocalDataChanged = false;
-
-    auto CaptureOldIfValue = [&](const FDaxNodeID ID) {
-        if (OldValueMap.contains(ID)) return;
-        ArzDax::FDaxNode* Node = Allocator.TryGetNode(ID);
-        if (!Node) return;
-        const UScriptStruct* Type = Allocator.GetValueType(ID);
-        const bool IsValueType = (Type && Type != FDaxFakeTypeEmpty::StaticStruct() && Type !=
-            FDaxFakeTypeArray::StaticStruct() && Type != FDaxFakeTypeMap::StaticStruct());
-        if (!IsValueType) return;
-        const FConstStructView SV = Node->TryGetValueGeneric();
-        if (!SV.IsValid()) return;
-        OldValueMap.emplace(ID, FInstancedStruct(SV));
+
+    bool bLocalStructChanged = Resume ? Resume->bStructChanged : false;
+    bool bLocalDataChanged = Resume ? Resume->bDataChanged : false;
+
+    // 服务端本次触达的节点, 读取结束后结算其上的预测; 没有预测时不收集
+    TArray<FDaxNodeID> PredictionTouched;
+    if (Resume) PredictionTouched = Resume->PredictionTouched;
+    const bool bHasPredictions = !OverlayMap.empty();
+
+    // 键名下标未定义时 Reader 已被标记为错误, 调用方必须中止读取, 不能把子节点挂到 NAME_None 下
+    auto ReadMapKey = [&](FName& OutKey) { return FDaxNetKeyCodec::Read(Reader, ClientKeyTable, OutKey); };
+
+    // 编辑脚本只回调下标变化的元素, 其余父边保持不动
+    auto UpdateArrayEdge = [&](const FDaxNodeID Child, const int32 Index) {
+        if (Child.IsValid()) Allocator.UpdateParentEdgeArray(Child, static_cast<uint16>(Index));
     };
 
-    uint32 AddsCount = 0, RemovesCount = 0, UpdatesCount = 0;
-    Reader.SerializeIntPacked(AddsCount);
-    Reader.SerializeIntPacked(RemovesCount);
-    Reader.SerializeIntPacked(UpdatesCount);
-    DAX_NET_SYNC_LOG(Warning, "Delta counts: Adds={0} Removes={1} Updates={2}", AddsCount, RemovesCount, UpdatesCount);
-    if (RemovesCount > 0 || AddsCount > 0) { bLocalStructChanged = true; }
 
-    for (uint32 i = 0; i < RemovesCount; ++i) {
-        FDaxNodeID NodeID;
-        Reader << NodeID;
-        // 记录本帧变更
-        FrameChangedNodes.insert(NodeID);
-        if (Allocator.IsNodeValid(NodeID)) {
-            CaptureOldIfValue(NodeID);
-            ReleaseRecursive(NodeID);
+    uint32 AddsCount = 0, RemovesCount = 0, UpdatesCount = 0;
+    const uint8 StartPhase = Resume ? Resume->Phase : 0;
+    if (Resume) { // 续读: 头部与中断之前的记录已经应用
+        AddsCount = Resume->AddsCount;
+        RemovesCount = Resume->RemovesCount;
+        UpdatesCount = Resume->UpdatesCount;
+    }
+    else {
+        // 服务端仍有延后的新增节点时保持水合状态, 完成的那一帧通知监听者
+        uint8 bHydrating = 0;
+        Reader.SerializeBits(&bHydrating, 1);
+        if (bClientHydrating && !bHydrating) bClientHydratedEvent = true;
+        bClientHydrating = bHydrating != 0;
+        uint8 bWatermark = 0;
+        Reader.SerializeBits(&bWatermark, 1);
+        if (bWatermark) Reader.SerializeIntPacked(ClientPredictionWatermark);
+
+        Reader.SerializeIntPacked(AddsCount);
+        Reader.SerializeIntPacked(RemovesCount);
+        Reader.SerializeIntPacked(UpdatesCount);
+        DAX_NET_SYNC_LOG(Warning, "Delta counts: Adds={0} Removes={1} Updates={2}", AddsCount, RemovesCount, UpdatesCount);
+        if (RemovesCount > 0 || AddsCount > 0) { bLocalStructChanged = true; }
+
+        FDaxNodeIDListCodec RemoveIDs;
+        for (uint32 i = 0; i < RemovesCount; ++i) {
+            FDaxNodeID NodeID;
+            RemoveIDs.Read(Reader, NodeID);
+            if (Reader.IsError()) return false;
+            // 记录本帧变更
+            MarkFrameChanged(NodeID, EDaxChangeKind::Removed);
+            if (bHasPredictions) PredictionTouched.Add(NodeID);
+            if (Allocator.IsNodeValid(NodeID)) {
+                CaptureOldValue(NodeID);
+                ReleaseRecursive(NodeID);
+            }
         }
     }
 
-    for (uint32 i = 0; i < AddsCount; ++i) {
+    // 类型未映射: 从这条记录起暂存剩余比特, 已应用的部分保留, 续读时接着应用
+    auto StageRemaining = [&](const uint8 Phase, const uint32 Next, const FDaxNodeIDListCodec& IDs, const int64 RecordStart) {
+        FDaxNetReadCursor Cursor;
+        Cursor.Kind = EDaxNetReadKind::Delta;
+        Cursor.Phase = Phase;
+        Cursor.Next = Next;
+        Cursor.AddsCount = AddsCount;
+        Cursor.RemovesCount = RemovesCount;
+        Cursor.UpdatesCount = UpdatesCount;
+        Cursor.IDs = IDs;
+        Cursor.bStructChanged = bLocalStructChanged;
+        Cursor.bDataChanged = bLocalDataChanged;
+        Cursor.PredictionTouched = MoveTemp(PredictionTouched);
+        StagePendingNetRead(Reader, RecordStart, MoveTemp(Cursor));
+        DeltaParms.bOutHasMoreUnmapped = true;
+    };
+
+    FDaxNodeIDListCodec AddIDs = StartPhase == 1 ? Resume->IDs : FDaxNodeIDListCodec();
+    for (uint32 i = StartPhase == 1 ? Resume->Next : (StartPhase > 1 ? AddsCount : 0); i < AddsCount; ++i) {
         const int32 StartBits = Reader.GetPosBits();
+        const FDaxNodeIDListCodec RecordIDs = AddIDs;
         FDaxNodeID NodeID;
-        Reader << NodeID;
+        AddIDs.Read(Reader, NodeID);
+        if (Reader.IsError()) return false;
         uint8 Flags = 0;
         Reader << Flags;
         FDaxNodeID Parent{};
         TObjectPtr<const UScriptStruct> TempType = nullptr;
         if (ArzDax::DaxFlagHasParent(Flags)) Reader << Parent;
         if (ArzDax::DaxFlagHasType(Flags)) {
-            UObject* TempTypeObject = nullptr;
-            const bool bTypeMapped = DeltaParms.Map->SerializeObject(Reader, UScriptStruct::StaticClass(), TempTypeObject);
-            if (!bTypeMapped) {
-                DAX_NET_SYNC_LOG(Warning, "Delta-Add: Unmapped UScriptStruct for node {0}, flags={1}. Defer.", NodeID.ToString(), FString::Printf(TEXT("0x%X"), Flags));
-                DeltaParms.bOutHasMoreUnmapped = true;
+            const UScriptStruct* ReadType = nullptr;
+            if (!FDaxNetTypeCodec::Read(Reader, DeltaParms.Map, ClientTypeTable, ReadType)) {
+                if (Reader.IsError()) return false;
+                DAX_NET_SYNC_LOG(Warning, "Delta-Add: Unmapped UScriptStruct for node {0}, flags={1}. Stage.", NodeID.ToString(), FString::Printf(TEXT("0x%X"), Flags));
+                StageRemaining(1, i, RecordIDs, StartBits);
                 return true;
             }
-            TempType = Cast<UScriptStruct>(TempTypeObject);
+            TempType = ReadType;
         }
         Allocator.AllocateSlotAt(NodeID);
+        if (ArzDax::DaxFlagHasParent(Flags) && !Parent.IsValid()) RootID = NodeID; // 分帧水合时根节点也走新增
         if (auto ParentRef = Allocator.GetParentRef(NodeID); ParentRef) {
             if (ArzDax::DaxFlagHasParent(Flags)) *ParentRef = Parent;
             if (TempType) Allocator.UpdateValueType(NodeID, TempType);
@@ -1353,20 +3059,8 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
 
         ArzDax::FDaxNode* Node = Allocator.TryGetNode(NodeID);
         auto ConsumeValuePayload = [&](const UScriptStruct* Type) {
-            if (Node) {
-                Node->SerializeValueData(Reader, DeltaParms.Map, Type);
-            }
-            else {
-                FInstancedStruct Temp;
-                Temp.InitializeAs(Type);
-                if (Type && Type->GetCppStructOps()->HasNetSerializer()) {
-                    bool Success = true;
-                    Type->GetCppStructOps()->NetSerialize(Reader, DeltaParms.Map, Success, Temp.GetMutableMemory());
-                }
-                else if (Type) {
-                    Type->SerializeBin(Reader, Temp.GetMutableMemory());
-                }
-            }
+            if (Node) Node->SerializeValueData(Reader, DeltaParms.Map, Type);
+            else ArzDax::FDaxNode::SkipValueData(Reader, DeltaParms.Map, Type);
         };
 
         const FString TypeName = TempType ? TempType->GetName() : TEXT("null");
@@ -1407,36 +3101,12 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                 Reader << kind;
                 if (kind == 1) { if (Node) { if (auto* Arr = Node->GetArray()) Arr->Empty(); } }
                 else {
-                    uint32 Start = 0, OldCount = 0, NewCount = 0;
-                    Reader.SerializeIntPacked(Start);
-                    Reader.SerializeIntPacked(OldCount);
-                    Reader.SerializeIntPacked(NewCount);
-                    if (Node) {
-                        if (auto* Arr = Node->GetArray()) {
-                            Arr->Empty();
-                            Arr->Reserve(Start + NewCount);
-                            for (uint32 k = 0; k < NewCount; ++k) {
-                                FDaxNodeID C;
-                                Reader << C;
-                                Arr->Add(C);
-                            }
-                            // 构建反向映射：数组
-                            for (int32 iArr = 0; iArr < Arr->Num(); ++iArr) {
-                                const FDaxNodeID Cid = (*Arr)[iArr];
-                                if (Cid.IsValid()) Allocator.UpdateParentEdgeArray(Cid, (uint16)iArr);
-                            }
-                        }
-                        else {
-                            for (uint32 k = 0; k < NewCount; ++k) {
-                                FDaxNodeID C;
-                                Reader << C;
-                            }
-                        }
-                    }
-                    else {
-                        for (uint32 k = 0; k < NewCount; ++k) {
-                            FDaxNodeID C;
-                            Reader << C;
+                    FDaxArrayEditScript Script;
+                    if (!FDaxArrayDiff::Read(Reader, Script)) return false;
+                    if (auto* Arr = Node ? Node->GetArray() : nullptr) {
+                        // 前一个包丢失时脚本的基线与本地数组不一致, 跳过脚本; 服务端处理该丢包回执时退回已确认的基线, 重新发送这段变化
+                        if (!FDaxArrayDiff::Apply(*Arr, Script, UpdateArrayEdge)) {
+                            DAX_NET_SYNC_LOG(Verbose, "DaxSet::Sync_ClientDeltaRead: skipping array edit script for {0}, base not received", NodeID.ToString());
                         }
                     }
                 }
@@ -1456,7 +3126,7 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                         for (uint32 k = 0; k < Count; ++k) {
                             FName K;
                             FDaxNodeID C;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                             Reader << C;
                             (*Map)[K] = C;
                             Allocator.UpdateParentEdgeMap(C, K);
@@ -1466,7 +3136,7 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                         for (uint32 k = 0; k < Count; ++k) {
                             FName K;
                             FDaxNodeID Dummy;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                             Reader << Dummy;
                         }
                     }
@@ -1475,7 +3145,7 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                     for (uint32 k = 0; k < Count; ++k) {
                         FName K;
                         FDaxNodeID Dummy;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << Dummy;
                     }
                 }
@@ -1489,13 +3159,13 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                     if (auto* Map = Node->GetMap()) {
                         for (uint32 k = 0; k < Rm; ++k) {
                             FName K;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                             Map->erase(K);
                         }
                         for (uint32 k = 0; k < Ad; ++k) {
                             FName K;
                             FDaxNodeID C;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                             Reader << C;
                             (*Map)[K] = C;
                             Allocator.UpdateParentEdgeMap(C, K);
@@ -1503,7 +3173,7 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                         for (uint32 k = 0; k < Rb; ++k) {
                             FName K;
                             FDaxNodeID C;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                             Reader << C;
                             (*Map)[K] = C;
                             Allocator.UpdateParentEdgeMap(C, K);
@@ -1512,18 +3182,18 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                     else {
                         for (uint32 k = 0; k < Rm; ++k) {
                             FName K;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                         }
                         for (uint32 k = 0; k < Ad; ++k) {
                             FName K;
                             FDaxNodeID C;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                             Reader << C;
                         }
                         for (uint32 k = 0; k < Rb; ++k) {
                             FName K;
                             FDaxNodeID C;
-                            Reader << K;
+                            if (!ReadMapKey(K)) return false;
                             Reader << C;
                         }
                     }
@@ -1531,18 +3201,18 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                 else {
                     for (uint32 k = 0; k < Rm; ++k) {
                         FName K;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                     }
                     for (uint32 k = 0; k < Ad; ++k) {
                         FName K;
                         FDaxNodeID C;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << C;
                     }
                     for (uint32 k = 0; k < Rb; ++k) {
                         FName K;
                         FDaxNodeID C;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << C;
                     }
                 }
@@ -1560,14 +3230,18 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
         }
 
         // 记录本帧变更
-        FrameChangedNodes.insert(NodeID);
+        MarkFrameChanged(NodeID, EDaxChangeKind::Added);
         const int32 EndBits = Reader.GetPosBits();
         DAX_NET_SYNC_LOG(Warning, "Delta-Add[{0}] bits {1}->{2} (+{3})", i, StartBits, EndBits, EndBits - StartBits);
     }
 
-    for (uint32 i = 0; i < UpdatesCount; ++i) {
+    FDaxNodeIDListCodec UpdateIDs = StartPhase == 2 ? Resume->IDs : FDaxNodeIDListCodec();
+    for (uint32 i = StartPhase == 2 ? Resume->Next : 0; i < UpdatesCount; ++i) {
+        const int64 RecordStart = Reader.GetPosBits();
+        const FDaxNodeIDListCodec RecordIDs = UpdateIDs;
         FDaxNodeID NodeID;
-        Reader << NodeID;
+        UpdateIDs.Read(Reader, NodeID);
+        if (Reader.IsError()) return false;
         uint8 Flags = 0;
         Reader << Flags;
         FDaxNodeID Parent{};
@@ -1577,14 +3251,14 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
             bLocalStructChanged = true;
         }
         if (ArzDax::DaxFlagHasType(Flags)) {
-            UObject* TempTypeObject = nullptr;
-            const bool bTypeMapped = DeltaParms.Map->SerializeObject(Reader, UScriptStruct::StaticClass(), TempTypeObject);
-            if (!bTypeMapped) {
-                DAX_NET_SYNC_LOG(Warning, "Delta-Update: Unmapped UScriptStruct for node {0}, flags={1}. Defer.", NodeID.ToString(), FString::Printf(TEXT("0x%X"), Flags));
-                DeltaParms.bOutHasMoreUnmapped = true;
+            const UScriptStruct* ReadType = nullptr;
+            if (!FDaxNetTypeCodec::Read(Reader, DeltaParms.Map, ClientTypeTable, ReadType)) {
+                if (Reader.IsError()) return false;
+                DAX_NET_SYNC_LOG(Warning, "Delta-Update: Unmapped UScriptStruct for node {0}, flags={1}. Stage.", NodeID.ToString(), FString::Printf(TEXT("0x%X"), Flags));
+                StageRemaining(2, i, RecordIDs, RecordStart);
                 return true;
             }
-            TempType = Cast<UScriptStruct>(TempTypeObject);
+            TempType = ReadType;
             bLocalStructChanged = true;
         }
         Allocator.AllocateSlotAt(NodeID);
@@ -1592,9 +3266,10 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
             if (InfoRef.pParent && ArzDax::DaxFlagHasParent(Flags)) *InfoRef.pParent = Parent;
             if (TempType) Allocator.UpdateValueType(NodeID, TempType);
         }
+        if (bHasPredictions && (ArzDax::DaxFlagHasValue(Flags) || ArzDax::DaxFlagHasType(Flags))) PredictionTouched.Add(NodeID);
         const UScriptStruct* EffType = TempType ? TempType.Get() : Allocator.GetValueType(NodeID);
         ArzDax::FDaxNode* Node = Allocator.TryGetNode(NodeID);
-        if (Node && Node->IsValue()) { CaptureOldIfValue(NodeID); }
+        if (Node && Node->IsValue()) { CaptureOldValue(NodeID); }
         if (!EffType || EffType == FDaxFakeTypeEmpty::StaticStruct()) {
             if (Node) {
                 Node->ResetToEmpty();
@@ -1604,21 +3279,24 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
         }
         const bool IsArrayType = (EffType == FDaxFakeTypeArray::StaticStruct());
         const bool IsMapType = (EffType == FDaxFakeTypeMap::StaticStruct());
-        if (ArzDax::DaxFlagHasValue(Flags)) {
+        if (ArzDax::DaxFlagHasValue(Flags) && ArzDax::DaxFlagHasPropDelta(Flags)) {
+            // 属性级增量直接写回现有值; 本地值缺失或类型不符时读入临时对象, 保证比特流对齐
+            const FStructView SV = Node ? Node->TryGetValueGenericMutable() : FStructView();
+            if (SV.GetScriptStruct() == EffType) {
+                FDaxPropertyDelta::Read(Reader, DeltaParms.Map, EffType, SV.GetMemory());
+            }
+            else {
+                ArzDax::FDaxNode::WithScratchValue(EffType, [&](void* Memory) { FDaxPropertyDelta::Read(Reader, DeltaParms.Map, EffType, Memory); });
+            }
+            bLocalDataChanged = true;
+        }
+        else if (ArzDax::DaxFlagHasValue(Flags)) {
             if (Node) {
                 Node->SerializeValueData(Reader, DeltaParms.Map, EffType);
                 Allocator.UpdateValueType(NodeID, EffType);
             }
             else {
-                FInstancedStruct Temp;
-                Temp.InitializeAs(EffType);
-                if (EffType->GetCppStructOps()->HasNetSerializer()) {
-                    bool Success = true;
-                    EffType->GetCppStructOps()->NetSerialize(Reader, DeltaParms.Map, Success, Temp.GetMutableMemory());
-                }
-                else {
-                    EffType->SerializeBin(Reader, Temp.GetMutableMemory());
-                }
+                ArzDax::FDaxNode::SkipValueData(Reader, DeltaParms.Map, EffType);
             }
             bLocalDataChanged = true;
         }
@@ -1659,41 +3337,11 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                     if (Arr) Arr->Empty();
                 }
                 else {
-                    uint32 Start = 0, OldCount = 0, NewCount = 0;
-                    Reader.SerializeIntPacked(Start);
-                    Reader.SerializeIntPacked(OldCount);
-                    Reader.SerializeIntPacked(NewCount);
-                    if (Arr) {
-                        const int32 S = static_cast<int32>(Start);
-                        const int32 OC = static_cast<int32>(OldCount);
-                        const int32 NC = static_cast<int32>(NewCount);
-                        if (S >= 0 && S <= Arr->Num()) {
-                            const int32 Rem = FMath::Clamp(OC, 0, Arr->Num() - S);
-                            if (Rem > 0) Arr->RemoveAt(S, Rem, EAllowShrinking::No);
-                            for (int32 k = 0; k < NC; ++k) {
-                                FDaxNodeID C;
-                                Reader << C;
-                                Arr->Insert(C, S + k);
-                            }
-                            // 刷新从 S 开始到末尾的反向映射
-                            for (int32 iArr = S; iArr < Arr->Num(); ++iArr) {
-                                const FDaxNodeID Cid = (*Arr)[iArr];
-                                if (Cid.IsValid()) Allocator.UpdateParentEdgeArray(Cid, (uint16)iArr);
-                            }
-                        }
-                        else {
-                            for (uint32 k = 0; k < NewCount; ++k) {
-                                FDaxNodeID C;
-                                Reader << C;
-                                Arr->Add(C);
-                            }
-                        }
-                    }
-                    else {
-                        for (uint32 k = 0; k < NewCount; ++k) {
-                            FDaxNodeID C;
-                            Reader << C;
-                        }
+                    FDaxArrayEditScript Script;
+                    if (!FDaxArrayDiff::Read(Reader, Script)) return false;
+                    // 基线不一致时跳过, 等待服务端从已确认的基线重发
+                    if (Arr && !FDaxArrayDiff::Apply(*Arr, Script, UpdateArrayEdge)) {
+                        DAX_NET_SYNC_LOG(Verbose, "DaxSet::Sync_ClientDeltaRead: skipping array edit script for {0}, base not received", NodeID.ToString());
                     }
                 }
                 if (Node) Allocator.UpdateValueType(NodeID, FDaxFakeTypeArray::StaticStruct());
@@ -1712,7 +3360,7 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                     for (uint32 k = 0; k < Count; ++k) {
                         FName K;
                         FDaxNodeID C;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << C;
                         (*Map)[K] = C;
                         Allocator.UpdateParentEdgeMap(C, K);
@@ -1722,7 +3370,7 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                     for (uint32 k = 0; k < Count; ++k) {
                         FName K;
                         FDaxNodeID Dummy;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << Dummy;
                     }
                 }
@@ -1738,13 +3386,13 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                 if (Map) {
                     for (uint32 k = 0; k < Rm; ++k) {
                         FName K;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Map->erase(K);
                     }
                     for (uint32 k = 0; k < Ad; ++k) {
                         FName K;
                         FDaxNodeID C;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << C;
                         (*Map)[K] = C;
                         Allocator.UpdateParentEdgeMap(C, K);
@@ -1752,7 +3400,7 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                     for (uint32 k = 0; k < Rb; ++k) {
                         FName K;
                         FDaxNodeID C;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << C;
                         (*Map)[K] = C;
                         Allocator.UpdateParentEdgeMap(C, K);
@@ -1761,18 +3409,18 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                 else {
                     for (uint32 k = 0; k < Rm; ++k) {
                         FName K;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                     }
                     for (uint32 k = 0; k < Ad; ++k) {
                         FName K;
                         FDaxNodeID C;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << C;
                     }
                     for (uint32 k = 0; k < Rb; ++k) {
                         FName K;
                         FDaxNodeID C;
-                        Reader << K;
+                        if (!ReadMapKey(K)) return false;
                         Reader << C;
                     }
                 }
@@ -1781,13 +3429,23 @@ bool FDaxSet::Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms) {
                 bLocalDataChanged = true;
             }
         // 记录本帧变更
-        FrameChangedNodes.insert(NodeID);
+        MarkFrameChanged(NodeID, EDaxChangeKind::Value);
         }
         else {
             // 仅 Meta 更新
         }
     }
 
+    if (bHasPredictions) {
+        // 随祖先一起释放的节点不会单独出现在 Removes 里
+        if (RemovesCount > 0) {
+            for (const auto& KV : OverlayMap) {
+                if (!Allocator.IsNodeValid(KV.first)) PredictionTouched.AddUnique(KV.first);
+            }
+        }
+        ReconcilePredictions(&PredictionTouched);
+    }
+
     if (bLocalStructChanged) {
         ++StructVersion;
         ++DataVersion;
@@ -2,7 +2,12 @@
 
 #include "CoreMinimal.h"
 #include "DaxSystem/Private/DaxAllocator.h"
+#include "DaxSystem/Private/DaxSetSnapshot.h"
+#include "DaxSystem/Private/DaxChangeLog.h"
+#include "DaxSystem/Private/DaxNetDictionary.h"
+#include "DaxSystem/Private/DaxIrisState.h"
 #include "DaxSystem/Public/DaxVisitor.h"
+#include "Misc/MemStack.h"
 #include "DaxSet.generated.h"
 
 DECLARE_STATS_GROUP(TEXT("DaxSystem"), STATGROUP_DaxSystem, STATCAT_DaxSystem)
@@ -12,9 +17,186 @@ DECLARE_CYCLE_STAT(TEXT("DaxSystem NetDeltaSync"), STAT_NetDeltaSync, STATGROUP_
 
 class UDaxComponent;
 class FDaxSetBaseState;
+struct FDaxWriteBatch;
+struct FDaxSet;
 
 DECLARE_DYNAMIC_DELEGATE_OneParam(FDaxOnChangedDynamic, const FDaxVisitor&, ChangePosition);
 
+UENUM(BlueprintType)
+enum class EDaxChangeKind : uint8 {
+    Value,   // 值或容器内容变化
+    Added,   // 本帧新建
+    Removed, // 本帧移除
+};
+
+// 聚合监听收到的一条变化: 监听位置的直接子节点(或监听位置自身)及其变化种类
+USTRUCT(BlueprintType)
+struct FDaxChangeRecord {
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly)
+    EDaxChangeKind Kind = EDaxChangeKind::Value;
+
+    UPROPERTY(BlueprintReadOnly)
+    FName Key {}; // 父容器为 Map 时的键名
+
+    UPROPERTY(BlueprintReadOnly)
+    int32 Index = INDEX_NONE; // 父容器为 Array 时的下标; Key 与 Index 都为空表示监听位置自身
+};
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FDaxOnChangedAggregateDynamic, const FDaxVisitor&, ListenPosition, const TArray<FDaxChangeRecord>&, Changes);
+
+// C++ 原生监听: 不经过反射调用, 也不构造访问器; 需要路径时再用 Set.GetVisitorFromNodeID(ID)
+// ChangedID: 只有一个变化节点且仍存在时为该节点, 否则为监听位置的节点
+DECLARE_DELEGATE_TwoParams(FDaxOnChangedNative, const FDaxSet& /*Set*/, FDaxNodeID /*ChangedID*/);
+DECLARE_DELEGATE_ThreeParams(FDaxOnChangedAggregateNative, const FDaxSet& /*Set*/, FDaxNodeID /*AnchorID*/, TConstArrayView<FDaxChangeRecord> /*Changes*/);
+
+// 本帧变更节点的记录; 移除的节点在释放前记下父边, 之后仍能按父链匹配监听
+struct FDaxFrameChange {
+    EDaxChangeKind Kind = EDaxChangeKind::Value;
+
+    ArzDax::EDaxParentEdgeKind EdgeKind = ArzDax::EDaxParentEdgeKind::None;
+
+    uint16 EdgeIndex = 0xFFFF;
+
+    FName EdgeLabel {};
+
+    FDaxNodeID Parent {};
+};
+
+// 子树的同步条件, 对不满足条件的连接: 子树根同步为空节点, 子孙节点完全不同步
+UENUM(BlueprintType)
+enum class EDaxNetCondition : uint8 {
+    None,      // 同步给所有连接
+    OwnerOnly, // 只同步给拥有者连接
+    SkipOwner, // 同步给拥有者以外的连接
+    Custom,    // 由谓词逐连接判断
+};
+
+// 返回 true 表示该连接可以看到子树
+DECLARE_DELEGATE_RetVal_OneParam(bool, FDaxNetConditionPredicate, const UNetConnection* /*Connection*/);
+
+struct FDaxNetConditionEntry {
+    EDaxNetCondition Condition = EDaxNetCondition::None;
+
+    FDaxNetConditionPredicate Predicate {};
+};
+
+// 某个连接本次写入时被过滤的节点
+struct FDaxNetFilter {
+    TSet<FDaxNodeID> HiddenRoots {}; // 同步为空节点
+
+    TSet<FDaxNodeID> HiddenNodes {}; // 完全不同步
+
+    bool bOwnerConnection = false; // 按拥有者过滤时该连接是否为拥有者连接
+
+    FORCEINLINE bool IsEmpty() const { return HiddenRoots.IsEmpty(); }
+
+    FORCEINLINE bool IsExcluded(const FDaxNodeID ID) const { return !HiddenNodes.IsEmpty() && HiddenNodes.Contains(ID); }
+
+    FORCEINLINE bool IsHiddenRoot(const FDaxNodeID ID) const { return !HiddenRoots.IsEmpty() && HiddenRoots.Contains(ID); }
+};
+
+// 分帧水合中延后的新增节点与排序键: 优先级高者先, 其次浅层, 最后下标; 键在节点第一次作为新增出现时确定
+struct FDaxNetPendingAdd {
+    FDaxNodeID ID {};
+
+    int32 Priority = 0;
+
+    int32 Depth = 0;
+
+    FORCEINLINE bool operator<(const FDaxNetPendingAdd& Other) const {
+        if (Priority != Other.Priority) return Priority > Other.Priority;
+        if (Depth != Other.Depth) return Depth < Other.Depth;
+        return ID.Index < Other.ID.Index;
+    }
+};
+
+// 客户端读取的续读进度: 因类型未映射而中断时记录所在的段与记录下标, 以及该段 ID 编码器的状态
+enum class EDaxNetReadKind : uint8 {
+    Full,
+    Delta,
+    Checkpoint, // 检查点在改动容器之前就会推迟, 续读时从头重新读取
+};
+
+struct FDaxNetReadCursor {
+    EDaxNetReadKind Kind = EDaxNetReadKind::Delta;
+
+    uint8 Phase = 0; // Delta: 0 移除, 1 新增, 2 更新
+
+    uint32 Next = 0; // 中断的记录下标, 续读从这条记录开始
+
+    uint32 NodeCount = 0;
+
+    uint32 AddsCount = 0;
+
+    uint32 RemovesCount = 0;
+
+    uint32 UpdatesCount = 0;
+
+    ArzDax::FDaxNodeIDListCodec IDs {};
+
+    FDaxNodeID RootCandidate {};
+
+    bool bStructChanged = false;
+
+    bool bDataChanged = false;
+
+    TArray<FDaxNodeID> PredictionTouched {};
+};
+
+struct FDaxStagedNetPacket {
+    TArray<uint8> Data {};
+
+    int64 NumBits = 0;
+};
+
+// 客户端: 中断记录起的剩余比特, 以及中断期间到达的后续包(整包排队, 保证应用顺序)
+struct FDaxPendingNetRead {
+    FDaxNetReadCursor Cursor {};
+
+    FDaxStagedNetPacket Remaining {};
+
+    TArray<FDaxStagedNetPacket> Queued {};
+
+    bool bOverflowWarned = false; // 排队数超过 dax.Net.MaxStagedPackets 时已提示过
+};
+
+// 客户端预测的结算结果
+UENUM(BlueprintType)
+enum class EDaxPredictionResult : uint8 {
+    Confirmed,  // 权威值与预测一致
+    Overridden, // 服务端写入了不同的值
+    Removed,    // 节点被服务端移除或整体重建
+    TimedOut,   // 超时仍未等到服务端触达该节点
+    Rejected,   // 服务端的写入权限检查拒绝了这次写入
+};
+
+// 预测结算回调: 预测键, 结算结果, 当时预测的值(空节点预测时无效)
+DECLARE_DELEGATE_ThreeParams(FDaxOnPredictionReconciled, uint32 /*PredictionKey*/, EDaxPredictionResult /*Result*/, FConstStructView /*PredictedValue*/);
+
+// 客户端 Overlay 条目: 本地预测值 + 预测键, 直到服务端触达该节点或超时才丢弃
+struct FDaxPredictionEntry {
+    TUniquePtr<ArzDax::FDaxNode> Node {};
+
+    uint32 PredictionKey = 0;
+
+    double PredictTime = 0.0;
+
+    bool bSentToServer = false; // 已随写入批次发出: 只有服务端处理过这次写入之后的同步才能结算它
+};
+
+// 已结算、等待 Subsystem 派发回调的预测
+struct FDaxPredictionResolved {
+    FDaxNodeID ID {};
+
+    uint32 PredictionKey = 0;
+
+    EDaxPredictionResult Result = EDaxPredictionResult::Confirmed;
+
+    TUniquePtr<ArzDax::FDaxNode> Predicted {};
+};
+
 struct FDaxOnChangedBinding {
 
     FDaxVisitor ListenPath {};
@@ -25,12 +207,52 @@ struct FDaxOnChangedBinding {
     
     FDaxOnChangedDynamic Delegate {}; // 动态委托（蓝图/反射安全）
 
-    bool IsValid() const { return Delegate.IsBound(); }
+    FDaxOnChangedAggregateDynamic AggregateDelegate {}; // bAggregate 时使用: 每帧一次, 附带变化的子节点列表
+
+    FDaxOnChangedNative NativeDelegate {}; // 原生委托, 绑定后优先于动态委托
+
+    FDaxOnChangedAggregateNative NativeAggregateDelegate {};
+
+    bool bCaptureOldValues = false; // 客户端读取同步数据时为子树内的值节点保存旧值, 供 TryGetOldValue 使用
+
+    bool bRemoved = false; // 派发期间解绑只做标记, 派发结束后再移除
+
+    bool IsValid() const {
+        if (bRemoved) return false;
+        return bAggregate ? (NativeAggregateDelegate.IsBound() || AggregateDelegate.IsBound()) : (NativeDelegate.IsBound() || Delegate.IsBound());
+    }
+
+    const UObject* GetTargetObject() const {
+        if (bAggregate) return NativeAggregateDelegate.IsBound() ? NativeAggregateDelegate.GetUObject() : AggregateDelegate.GetUObject();
+        return NativeDelegate.IsBound() ? NativeDelegate.GetUObject() : Delegate.GetUObject();
+    }
+
+    FDelegateHandle GetNativeHandle() const {
+        return bAggregate ? NativeAggregateDelegate.GetHandle() : NativeDelegate.GetHandle();
+    }
 
     // Cache
     FDaxNodeID AnchorID{};
     
     uint32 AnchorStructVersion = 0;
+
+    FDaxNodeID RemovedAnchorID{}; // 重新解析时发现本帧被移除的旧锚点, 收集时在第 0 层通知一次 Removed 后丢弃
+};
+
+// 本帧的旧值快照: 内存来自容器的帧内线性分配器, 派发结束后统一析构并整体释放
+struct FDaxOldValue {
+    const UScriptStruct* Type = nullptr;
+
+    void* Memory = nullptr;
+};
+
+// 本帧收集到、等待派发的一次监听回调; 访问器只在调用动态委托时才构造
+struct FDaxPendingOnChanged {
+    int32 BindingIndex = INDEX_NONE;
+
+    FDaxNodeID ChangedID {}; // 只有一个变化节点且仍存在时为该节点, 否则为锚点
+
+    TArray<FDaxChangeRecord> Changes {}; // 聚合监听: 按下标/键名排序, 每个子节点一条
 };
 
 USTRUCT(BlueprintType)
@@ -38,7 +260,7 @@ struct DAXSYSTEM_API FDaxSet {
     GENERATED_BODY()
 
     FDaxSet();
-    ~FDaxSet() = default;
+    ~FDaxSet();
     FDaxSet(const FDaxSet& Other);
     FDaxSet& operator=(const FDaxSet& Other);
     FDaxSet(FDaxSet&& Other) = delete;
@@ -47,6 +269,9 @@ struct DAXSYSTEM_API FDaxSet {
     FDaxVisitor GetVisitor() const { return FDaxVisitor(const_cast<FDaxSet*>(this), LiveToken); }
     FDaxVisitor GetVisitorFromPath(const FString& Path) const { return GetVisitor().MakeVisitorByParsePath(Path); }
 
+    // 沿父边反推路径, 节点无效或不在根之下时返回无效访问器
+    FDaxVisitor GetVisitorFromNodeID(const FDaxNodeID ID) const;
+
     FString GetString() const;
     FString GetStringDebug() const;
 
@@ -69,7 +294,7 @@ private:
 
     FORCEINLINE ArzDax::FDaxNode* TryGetNode(const FDaxNodeID ID) {
         if (!bRunningOnServer)
-            if (auto It = OverlayMap.find(ID); It != OverlayMap.end()) return It->second.Get();
+            if (auto It = OverlayMap.find(ID); It != OverlayMap.end()) return It->second.Node.Get();
         return Allocator.TryGetNode(ID);
     }
 
@@ -101,16 +326,43 @@ private:
     friend struct FDaxVisitor;
     friend class UDaxComponent;
 
+    FORCEINLINE void RecordChange(const FDaxNodeID ID) {
+        if (!bRunningOnServer) return;
+        ChangeLog.Record(DataVersion, ID);
+    }
+
+    // 同一节点本帧多次变化时: 移除优先, 其次新建, 最后才是值变化
+    FORCEINLINE void MarkFrameChanged(const FDaxNodeID ID, const EDaxChangeKind Kind) {
+        auto [It, bInserted] = FrameChangedNodes.try_emplace(ID);
+        FDaxFrameChange& Change = It->second;
+        if (!bInserted && static_cast<uint8>(Kind) <= static_cast<uint8>(Change.Kind)) return;
+        Change.Kind = Kind;
+        if (Kind == EDaxChangeKind::Removed && Allocator.IsNodeValid(ID)) { // 必须在释放之前调用
+            Change.Parent = Allocator.GetParent(ID);
+            Change.EdgeKind = Allocator.GetParentEdgeKind(ID);
+            Change.EdgeIndex = Allocator.GetParentEdgeIndex(ID);
+            Change.EdgeLabel = Allocator.GetParentEdgeLabel(ID);
+        }
+    }
+
+    static FORCEINLINE EDaxChangeKind ToChangeKind(const ArzDax::EDaxChangeOp Op) {
+        if (Op == ArzDax::EDaxChangeOp::AddNode) return EDaxChangeKind::Added;
+        if (Op == ArzDax::EDaxChangeOp::RemoveNode) return EDaxChangeKind::Removed;
+        return EDaxChangeKind::Value;
+    }
+
     FORCEINLINE void BumpOnlyNodeDataVersion(const FDaxNodeID ID) {
         if (!bRunningOnServer) return;
         Allocator.MarkDirty(ID, true);
-        FrameChangedNodes.insert(ID);
+        MarkFrameChanged(ID, EDaxChangeKind::Added);
+        RecordChange(ID); // 目前只有深拷贝新建节点走这里
     }
 
     FORCEINLINE void BumpNodeDataVersion(const FDaxNodeID ID) {
         if (!bRunningOnServer) return;
         Allocator.MarkDirty(ID, true);
-        FrameChangedNodes.insert(ID);
+        MarkFrameChanged(ID, EDaxChangeKind::Value);
+        RecordChange(ID);
         BumpDataVersion();
     }
 
@@ -119,10 +371,11 @@ private:
         Allocator.UpdateValueType(ID, NewType);
     }
 
-    FORCEINLINE void BumpNodeDataVersionAndStruct(const FDaxNodeID ID) {
+    FORCEINLINE void BumpNodeDataVersionAndStruct(const FDaxNodeID ID, const ArzDax::EDaxChangeOp Op = ArzDax::EDaxChangeOp::Struct) {
         if (!bRunningOnServer) return;
         Allocator.MarkDirty(ID, true);
-        FrameChangedNodes.insert(ID);
+        MarkFrameChanged(ID, ToChangeKind(Op));
+        RecordChange(ID);
         BumpStructVersion();
     }
 
@@ -155,18 +408,28 @@ private:
 
     //Client:
 
+    // 每次本地写入都视为一次新的预测: 分配新的预测键并重新计时
     ArzDax::FDaxNode* GetOrCreateOverlayValueNode(const FDaxNodeID ID) {
-        if (const auto It = OverlayMap.find(ID); It != OverlayMap.end()) {
-            return It->second.Get();
-        }
-        else {
-            auto Ref = OverlayMap.emplace(ID, MakeUnique<ArzDax::FDaxNode>());
-            return Ref.first->second.Get();
+        auto It = OverlayMap.find(ID);
+        if (It == OverlayMap.end()) {
+            It = OverlayMap.emplace(ID, FDaxPredictionEntry{MakeUnique<ArzDax::FDaxNode>()}).first;
         }
+        if (++PredictionKeyCounter == 0) ++PredictionKeyCounter; // 0 保留为"无预测"
+        It->second.PredictionKey = PredictionKeyCounter;
+        It->second.PredictTime = FPlatformTime::Seconds();
+        It->second.bSentToServer = false;
+        PendingWriteIDs.AddUnique(ID);
+        return It->second.Node.Get();
     }
 
     FORCEINLINE void ClearOverlayMap() { OverlayMap.clear(); }
 
+    // 服务端触达了这些节点(nullptr 表示全部), 按权威值结算对应的预测.
+    // 已发出、但服务端在这次同步时还没有处理到的预测(键大于水位)不结算, 那次触达早于这次写入
+    void ReconcilePredictions(const TArray<FDaxNodeID>* TouchedIDs);
+
+    void ResolvePrediction(const FDaxNodeID ID, FDaxPredictionEntry&& Entry, const EDaxPredictionResult Result);
+
 private:
     ArzDax::FDaxAllocator Allocator{};
 
@@ -184,17 +447,77 @@ private:
 
     TArray<FDaxOnChangedBinding> OnChangedBindings{};
 
-    ankerl::unordered_dense::map<FDaxNodeID, TUniquePtr<ArzDax::FDaxNode>,
+    TMap<FDaxNodeID, TArray<int32, TInlineAllocator<1>>> OnChangedAnchorIndex{}; // 锚点节点 -> 监听下标, 结构版本变化或增删监听时重建
+
+    uint32 OnChangedIndexStructVersion = 0;
+
+    int32 OnChangedMaxDepth = 0;
+
+    bool bOnChangedIndexDirty = true;
+
+    TArray<FDaxPendingOnChanged> PendingOnChanged{};
+
+    TArray<FDaxOnChangedBinding> DeferredOnChangedBindings{}; // 派发期间新增的监听, 派发结束后加入
+
+    bool bDispatchingOnChanged = false;
+
+    bool bOnChangedCompactPending = false;
+
+    TSharedPtr<const ArzDax::FDaxSetSnapshot> NetSnapshot{}; // 服务端最近一次生成的同步快照, 新版本只重建变化的块
+
+    TRefCountPtr<const ArzDax::FDaxIrisState> IrisQuantizedState{}; // Iris 服务端: 最近一次量化的状态, 下次只重建脏块
+
+    TRefCountPtr<const ArzDax::FDaxIrisState> IrisAppliedState{}; // Iris 客户端: 最近一次应用到容器的状态, 下次只应用变化的槽位
+
+    ArzDax::FDaxChangeLog ChangeLog{}; // 服务端变更日志, 覆盖范围内的连接只重放触达过的节点
+
+    ArzDax::FDaxNetTypeReader ClientTypeTable{}; // 客户端: 服务端定义过的类型下标
+
+    ArzDax::FDaxNetKeyReader ClientKeyTable{}; // 客户端: 服务端定义过的 Map 键名下标
+
+    TMap<FDaxNodeID, int32> NetPriorities{}; // 服务端: 子树根 -> 同步优先级
+
+    TMap<FDaxNodeID, float> NetUpdateIntervals{}; // 服务端: 子树根 -> 最小重发间隔(秒)
+
+    TMap<FDaxNodeID, FDaxNetConditionEntry> NetConditions{}; // 服务端: 子树根 -> 同步条件
+
+    uint32 NetConditionSerial = 0; // 条件变化计数, 与基线不一致时重新比较所有块
+
+    bool bNetHydrationPending = false;
+
+    bool bClientHydrating = false;
+
+    bool bClientHydratedEvent = false;
+
+    TUniquePtr<FDaxPendingNetRead> PendingNetRead{}; // 客户端: 等待类型映射后续读的数据, 在 bUpdateUnmappedObjects 中重试
+
+    uint32 PredictionKeyCounter = 0;
+
+    uint32 ProcessedPredictionKey = 0; // 服务端: 已处理的客户端写入中最大的预测键, 随同步下发作为水位
+
+    uint32 ClientPredictionWatermark = 0; // 客户端: 最近一次同步时服务端已处理到的预测键
+
+    TMap<FDaxNodeID, FDaxOnPredictionReconciled> PredictionCallbacks{}; // 客户端: 节点 -> 预测结算回调
+
+    TArray<FDaxPredictionResolved> ResolvedPredictions{}; // 客户端: 已结算待派发
+
+    TArray<FDaxNodeID> PendingWriteIDs{}; // 客户端: 本帧写过 Overlay、尚未打包发送的节点
+
+    ankerl::unordered_dense::map<FDaxNodeID, FDaxPredictionEntry,
                                  ArzDax::FDaxNodeIDHash, ArzDax::FDaxNodeIDEqual,
-                                 ArzDax::TDaxAllocator<std::pair<FDaxNodeID, TUniquePtr<ArzDax::FDaxNode>>>> OverlayMap{};
+                                 ArzDax::TDaxAllocator<std::pair<FDaxNodeID, FDaxPredictionEntry>>> OverlayMap{};
 
-    ankerl::unordered_dense::map<FDaxNodeID, FInstancedStruct,
+    ankerl::unordered_dense::map<FDaxNodeID, FDaxOldValue,
                                  ArzDax::FDaxNodeIDHash, ArzDax::FDaxNodeIDEqual,
-                                 ArzDax::TDaxAllocator<std::pair<FDaxNodeID, FInstancedStruct>>> OldValueMap{};
+                                 ArzDax::TDaxAllocator<std::pair<FDaxNodeID, FDaxOldValue>>> OldValueMap{};
 
-    ankerl::unordered_dense::set<FDaxNodeID,
+    FMemStackBase OldValueArena{}; // OldValueMap 的值内存, 每帧整体释放
+
+    int32 OldValueCaptureDepth = INDEX_NONE; // 需要旧值的监听中最大的深度, 没有这类监听时为 INDEX_NONE
+
+    ankerl::unordered_dense::map<FDaxNodeID, FDaxFrameChange,
                                  ArzDax::FDaxNodeIDHash, ArzDax::FDaxNodeIDEqual,
-                                 ArzDax::TDaxAllocator<FDaxNodeID>> FrameChangedNodes{};
+                                 ArzDax::TDaxAllocator<std::pair<FDaxNodeID, FDaxFrameChange>>> FrameChangedNodes{};
 
 public:
     void Clear();
@@ -207,20 +530,134 @@ public:
 
     FConstStructView TryGetOldValueByNodeID(const FDaxNodeID NodeID) const;
 
-    // 本帧变更节点集合：供 Subsystem 在分发后清理
-    FORCEINLINE void ClearFrameChangedNodes() { FrameChangedNodes.clear(); }
+    // 为某个值类型开启属性级增量同步: 值更新时只发送变化的属性(全局生效, 需在同步开始前设置)
+    static void SetPropertyDeltaEnabled(const UScriptStruct* Type, bool bEnabled);
+
+    // 本帧变更节点集合与旧值快照: 没有监听参与收集时由 Subsystem 直接清理
+    FORCEINLINE void ClearFrameChangedNodes() {
+        FrameChangedNodes.clear();
+        ReleaseOldValues();
+    }
+
+    // 旧值快照在派发之后释放; 变更集合已在 CollectOnChanged 中取走
+    FORCEINLINE void ReleaseFrameOldValues() { ReleaseOldValues(); }
+
+    // 设置子树的同步优先级(服务端): 新增节点超出预算分帧发送时, 优先级高的子树先发; 0 表示清除
+    bool SetNetPriority(const FDaxVisitor& Position, int32 Priority);
+
+    // 设置子树的最小重发间隔(服务端, 秒): 子树内的值更新在间隔内延后并合并, 结构变化不受影响; 0 表示清除
+    bool SetNetUpdateInterval(const FDaxVisitor& Position, float IntervalSeconds);
+
+    // 设置子树的同步条件(服务端), None 表示清除; Custom 需要提供谓词
+    bool SetNetCondition(const FDaxVisitor& Position, EDaxNetCondition Condition, FDaxNetConditionPredicate Predicate = {});
+
+    // 自定义谓词的结果发生变化(例如换队)时调用, 所有连接重新评估过滤
+    void RefreshNetConditions();
+
+    FORCEINLINE bool HasNetConditions() const { return !NetConditions.IsEmpty(); }
+
+    // 客户端: 分帧水合尚未完成
+    FORCEINLINE bool IsHydrating() const { return bClientHydrating; }
+
+    // 客户端: 水合完成后由 Subsystem 取走并广播 OnHydrated
+    bool ConsumeHydratedEvent();
+
+    // 服务端: 有连接还有延后的新增节点或限频更新, Subsystem 需要继续标脏以驱动下一次写入
+    FORCEINLINE bool ConsumeNetHydrationPending() {
+        const bool bPending = bNetHydrationPending;
+        bNetHydrationPending = false;
+        return bPending;
+    }
+
+    FSimpleMulticastDelegate OnHydrated;
+
+    // 客户端: 节点当前预测值的预测键, 没有未结算的预测时返回 0
+    uint32 GetPredictionKey(const FDaxVisitor& Position) const;
+
+    // 客户端: 设置节点的预测结算回调, 传入未绑定的委托表示清除
+    bool SetPredictionReconcileCallback(const FDaxVisitor& Position, FDaxOnPredictionReconciled Callback);
+
+    // 客户端: 由 Subsystem 每帧调用, 处理超时的预测并派发结算回调
+    void FlushPredictions(double Now);
+
+    // 客户端: 按预测键结算(服务端的写入确认)
+    void AckPredictions(TConstArrayView<uint32> PredictionKeys, EDaxPredictionResult Result);
+
+    // 客户端: 取走本帧的预测写入打包成一批, 没有可发送的写入时返回 false.
+    // bDeliver 为 false 时批次不会发出, 这些预测仍按服务端的触达结算
+    bool ConsumeWriteBatch(FDaxWriteBatch& OutBatch, bool bDeliver = true);
+
+    // 服务端: 逐条经 Authorize 检查后写入, 被拒绝的与值未变化的预测键分别输出, 供回执给客户端
+    void ApplyWriteBatch(const FDaxWriteBatch& Batch, TFunctionRef<bool(const FDaxVisitor&, FConstStructView)> Authorize,
+                         TArray<uint32>& OutRejected, TArray<uint32>& OutUnchanged);
 
 public:
-    bool BindOnChanged(const FDaxVisitor& Position, int32 Depth, const FDaxOnChangedDynamic& Delegate);
+    // bCaptureOldValues: 只有开启的监听子树内才保存旧值, 其余节点的 TryGetOldValue 返回空
+    bool BindOnChanged(const FDaxVisitor& Position, int32 Depth, const FDaxOnChangedDynamic& Delegate, bool bCaptureOldValues = false);
+    // 聚合监听: 子树内的变化每帧只回调一次, 附带变化的直接子节点列表
+    bool BindOnChangedAggregate(const FDaxVisitor& Position, int32 Depth, const FDaxOnChangedAggregateDynamic& Delegate, bool bCaptureOldValues = false);
+    // 原生监听, 返回的句柄用于 UnbindOnChangedNative; 按位置/对象解绑同样生效
+    FDelegateHandle BindOnChangedNative(const FDaxVisitor& Position, int32 Depth, FDaxOnChangedNative Delegate, bool bCaptureOldValues = false);
+    FDelegateHandle BindOnChangedAggregateNative(const FDaxVisitor& Position, int32 Depth, FDaxOnChangedAggregateNative Delegate, bool bCaptureOldValues = false);
+    void UnbindOnChangedNative(FDelegateHandle Handle);
     void UnbindOnChanged(const FDaxVisitor& Position);
     void UnbindAllFor(UObject* TargetObject);
 
+    FORCEINLINE bool HasOnChangedWork() const { return !OnChangedBindings.IsEmpty() && !FrameChangedNodes.empty(); }
+
+    // 由 Subsystem 每帧调用: 按本帧变更节点匹配监听, 每个监听每帧最多收集一次.
+    // 只读写本容器自身的状态, 不同容器可以在工作线程上并行收集
+    void CollectOnChanged();
+
+    // 派发 CollectOnChanged 收集到的回调, 回调中可以安全地增删监听
+    void DispatchOnChanged();
+
 private:
+    void RebuildOnChangedIndex();
+
+    bool AddOnChangedBinding(const FDaxVisitor& Position, int32 Depth, FDaxOnChangedBinding&& Binding);
+
+    void RemoveOnChangedBindings(TFunctionRef<bool(const FDaxOnChangedBinding&)> Predicate);
+
+    // 客户端读取前调用: 确保锚点表对应当前结构, CaptureOldValue 据此判断节点是否需要旧值
+    void PrepareOldValueCapture();
+
+    // 节点被覆盖或移除之前调用; 同一帧内只保留第一次的值
+    void CaptureOldValue(const FDaxNodeID ID);
+
+    void ReleaseOldValues();
+
+    TSharedPtr<const ArzDax::FDaxSetSnapshot> AcquireNetSnapshot();
+
+    int32 GetNetPriorityAndDepth(const FDaxNodeID ID, int32& OutDepth) const; // 最近祖先上设置的优先级
+
+    float GetNetUpdateInterval(const FDaxNodeID ID, FDaxNodeID& OutRoot) const; // 最近祖先上设置的重发间隔, 没有时返回 0
+
+    bool IsNetOwnerConnection(UPackageMap* Map) const; // 没有同步条件时恒为 false, 拥有者变化不会触发重新比较
+
+    void BuildNetFilter(UPackageMap* Map, FDaxNetFilter& OutFilter) const;
+
+    void CollectNetHiddenSubtree(const FDaxNodeID ID, FDaxNetFilter& OutFilter) const;
+
     bool Sync_ServerFullWrite(FNetDeltaSerializeInfo& DeltaParms);
-    bool Sync_ServerDeltaWrite(FNetDeltaSerializeInfo& DeltaParms, FDaxSetBaseState* OldState);
+    bool Sync_ServerDeltaWrite(FNetDeltaSerializeInfo& DeltaParms, FDaxSetBaseState* OldState, bool bBeginHydration = false);
+
+    bool Sync_ClientRead(FNetDeltaSerializeInfo& DeltaParms);
+    bool Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms, const FDaxNetReadCursor* Resume = nullptr);
+    bool Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms, const FDaxNetReadCursor* Resume = nullptr);
+
+    // 类型未映射时暂存剩余比特与进度; 续读按原顺序重放暂存数据和排队的包
+    void StagePendingNetRead(FBitReader& Reader, int64 RecordStartBits, FDaxNetReadCursor&& Cursor);
+    bool Sync_ClientResumeRead(FNetDeltaSerializeInfo& DeltaParms);
+
+    // 回放检查点: 类型/键名表与块布局写在头部, 回放端按布局与当前容器做差量, 拖动进度时只触达变化的节点
+    bool Sync_ServerCheckpointWrite(FNetDeltaSerializeInfo& DeltaParms);
+    bool Sync_ClientCheckpointRead(FNetDeltaSerializeInfo& DeltaParms);
 
-    bool Sync_ClientFullRead(FNetDeltaSerializeInfo& DeltaParms);
-    bool Sync_ClientDeltaRead(FNetDeltaSerializeInfo& DeltaParms);
+    // Iris 复制路径(见 DaxSetNetSerializer): 量化在游戏线程执行, 之后的序列化只读取量化状态
+    TRefCountPtr<const ArzDax::FDaxIrisState> Iris_Quantize();
+    void Iris_Apply(const ArzDax::FDaxIrisState& State);
+    void Iris_ApplySlot(const FDaxNodeID ID, const ArzDax::FDaxIrisSlot& Slot, const ArzDax::FDaxIrisSlot* OldSlot, bool& bOutStructChanged);
 };
 
 template <>
@@ -232,26 +669,40 @@ struct TStructOpsTypeTraits<FDaxSet> : public TStructOpsTypeTraitsBase2<FDaxSet>
 };
 
 class FDaxSetBaseState : public INetDeltaBaseState {
-    using FDaxArrayMirrorType = ankerl::unordered_dense::map<FDaxNodeID, TArray<FDaxNodeID>,
-                                                             ArzDax::FDaxNodeIDHash, ArzDax::FDaxNodeIDEqual, ArzDax::TDaxAllocator<std::pair<FDaxNodeID, TArray<FDaxNodeID>>>>;
-
-    using FDaxMapMirrorType = ankerl::unordered_dense::map<FDaxNodeID, ArzDax::FDaxMapType,
-                                                           ArzDax::FDaxNodeIDHash, ArzDax::FDaxNodeIDEqual, ArzDax::TDaxAllocator<std::pair<FDaxNodeID, ArzDax::FDaxMapType>>>;
-
 public:
     uint32 ContainerVersion{};
 
-    TArray<TUniquePtr<ArzDax::FDaxNodeChunkMeta>, TInlineAllocator<4>> ChildStates{};
+    uint32 ChunkEpoch{}; // 生成该基线时分配器的块 Epoch, 增量写入只需比较比它新的块
+
+    TSharedPtr<const ArzDax::FDaxSetSnapshot> Snapshot{}; // 同一版本的所有连接共享的只读快照
+
+    TSharedPtr<const ArzDax::FDaxNetTypeDictionary> TypeTable{}; // 该连接已确认的用户类型下标, 写时复制
+
+    TSharedPtr<const ArzDax::FDaxNetKeyDictionary> KeyTable{}; // 该连接已确认的 Map 键名下标, 写时复制
+
+    uint32 PendingNodes{}; // 超出预算延后的新增节点数, 非 0 时 Snapshot 是摘掉这些节点的部分快照
+
+    TArray<FDaxNetPendingAdd> PendingAdds{}; // 延后的新增节点, 已按发送顺序排好, 之后的写入只需与新出现的节点归并
+
+    uint32 NetConditionSerial{}; // 生成该基线时的同步条件计数, Snapshot 已按该连接的过滤结果处理
+
+    bool bOwnerConnection{}; // 生成该基线时该连接是否为拥有者连接, Actor 换了拥有者时与条件变化一样重新比较
+
+    uint32 PredictionWatermark{}; // 该连接已收到的预测水位, 变化时随增量下发
+
+    TArray<FDaxNodeID> StaleNodes{}; // 限频延后的值更新, Snapshot 里这些槽位仍是旧版本
 
-    FDaxArrayMirrorType ArrayMirror{};
+    TMap<FDaxNodeID, double> NextSendTimes{}; // 限频子树根 -> 该连接下次允许发送的时间
 
-    FDaxMapMirrorType MapMirror{};
+    double NextStaleSendTime = 0.0; // StaleNodes 中最早可以发送的时间
 
     virtual bool IsStateEqual(INetDeltaBaseState* OtherState) override {
         FDaxSetBaseState* Other = static_cast<FDaxSetBaseState*>(OtherState);
         if (!Other) return false;
 
-        if (ContainerVersion == Other->ContainerVersion) return true;
+        if (ContainerVersion == Other->ContainerVersion && PendingNodes == Other->PendingNodes && NetConditionSerial == Other->NetConditionSerial &&
+            bOwnerConnection == Other->bOwnerConnection &&
+            StaleNodes.Num() == Other->StaleNodes.Num()) return true;
         return false;
     }
 
@@ -0,0 +1,404 @@
+﻿#include "DaxSystem/Private/DaxSetNetSerializer.h"
+
+#if UE_WITH_IRIS
+#include "DaxSystem/Private/DaxCommon.h"
+#include "Iris/ReplicationState/PropertyNetSerializerInfoRegistry.h"
+#include "Iris/Serialization/NetBitStreamReader.h"
+#include "Iris/Serialization/NetBitStreamUtil.h"
+#include "Iris/Serialization/NetBitStreamWriter.h"
+#include "Iris/Serialization/NetSerializationContext.h"
+#include "Iris/Serialization/NetSerializerDelegates.h"
+
+namespace UE::Net {
+
+    // 线上格式(全量/增量共用):
+    // 预测水位 -> 块数 -> 每块: [增量: 1bit 块有变化] 1bit 存在 -> 32bit UsedMask -> 每个槽位: [增量: 1bit 与基线相同] 槽位数据
+    // 槽位数据: 16bit 代 + 父节点 + 类型 + 内容(值的比特 / 数组子节点 / Map 键值)
+    // 类型与键名在单个包内建立字典, 首次出现时内联路径/字符串, 之后只发下标
+    struct FDaxSetNetSerializer {
+        static constexpr uint32 Version = 0;
+        static constexpr bool bHasDynamicState = true;
+
+        struct FQuantizedType {
+            const ArzDax::FDaxIrisState* State;
+        };
+
+        typedef FDaxIrisStateHandle SourceType;
+        typedef FQuantizedType QuantizedType;
+        typedef FDaxSetNetSerializerConfig ConfigType;
+
+        static const ConfigType DefaultConfig;
+
+        static void Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args);
+        static void Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args);
+
+        static void SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args);
+        static void DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args);
+
+        static void Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args);
+        static void Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args);
+
+        static bool IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args);
+        static bool Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args);
+
+        static void CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args);
+        static void FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args);
+    };
+
+    UE_NET_IMPLEMENT_SERIALIZER(FDaxSetNetSerializer);
+
+    const FDaxSetNetSerializer::ConfigType FDaxSetNetSerializer::DefaultConfig;
+
+    namespace DaxIris {
+        using namespace ArzDax;
+
+        enum : uint32 {
+            TypeKindEmpty = 0,
+            TypeKindArray = 1,
+            TypeKindMap = 2,
+            TypeKindValue = 3,
+        };
+
+        constexpr uint32 MaxChunks = DAX_NODE_POOR_MAX_CHUNKS;
+        constexpr uint32 MaxStringBytes = 1024;
+        constexpr uint32 MaxPayloadBits = 1u << 20;
+
+        struct FWriteContext {
+            FNetBitStreamWriter* Writer = nullptr;
+            TMap<const UScriptStruct*, uint32> Types {};
+            TMap<FName, uint32> Names {};
+        };
+
+        struct FReadContext {
+            FNetSerializationContext* Context = nullptr;
+            FNetBitStreamReader* Reader = nullptr;
+            TArray<const UScriptStruct*> Types {};
+            TArray<FName> Names {};
+
+            bool Fail() const {
+                Context->SetError(GNetError_InvalidValue);
+                return false;
+            }
+        };
+
+        void WriteBytes(FNetBitStreamWriter* Writer, const uint8* Data, const uint32 NumBits) {
+            const uint32 FullBytes = NumBits >> 3;
+            for (uint32 i = 0; i < FullBytes; ++i) Writer->WriteBits(Data[i], 8);
+            if (const uint32 Tail = NumBits & 7) Writer->WriteBits(Data[FullBytes], Tail);
+        }
+
+        void ReadBytes(FNetBitStreamReader* Reader, uint8* Data, const uint32 NumBits) {
+            const uint32 FullBytes = NumBits >> 3;
+            for (uint32 i = 0; i < FullBytes; ++i) Data[i] = static_cast<uint8>(Reader->ReadBits(8));
+            if (const uint32 Tail = NumBits & 7) Data[FullBytes] = static_cast<uint8>(Reader->ReadBits(Tail));
+        }
+
+        void WriteString(FNetBitStreamWriter* Writer, const FString& String) {
+            const FTCHARToUTF8 Utf8(*String);
+            const uint32 Length = FMath::Min(static_cast<uint32>(Utf8.Length()), MaxStringBytes);
+            WritePackedUint32(Writer, Length);
+            WriteBytes(Writer, reinterpret_cast<const uint8*>(Utf8.Get()), Length * 8);
+        }
+
+        bool ReadString(FReadContext& Ctx, FString& OutString) {
+            const uint32 Length = ReadPackedUint32(Ctx.Reader);
+            if (Length > MaxStringBytes) return Ctx.Fail();
+            TArray<uint8, TInlineAllocator<128>> Bytes;
+            Bytes.SetNumUninitialized(Length + 1);
+            ReadBytes(Ctx.Reader, Bytes.GetData(), Length * 8);
+            Bytes[Length] = 0;
+            OutString = FString(UTF8_TO_TCHAR(reinterpret_cast<const ANSICHAR*>(Bytes.GetData())));
+            return !Ctx.Reader->IsOverflown();
+        }
+
+        void WriteName(FWriteContext& Ctx, const FName Name) {
+            if (const uint32* Index = Ctx.Names.Find(Name)) {
+                Ctx.Writer->WriteBool(true);
+                WritePackedUint32(Ctx.Writer, *Index);
+                return;
+            }
+            Ctx.Writer->WriteBool(false);
+            Ctx.Names.Add(Name, Ctx.Names.Num());
+            WriteString(Ctx.Writer, Name.ToString());
+        }
+
+        bool ReadName(FReadContext& Ctx, FName& OutName) {
+            if (Ctx.Reader->ReadBool()) {
+                const uint32 Index = ReadPackedUint32(Ctx.Reader);
+                if (!Ctx.Names.IsValidIndex(static_cast<int32>(Index))) return Ctx.Fail();
+                OutName = Ctx.Names[Index];
+                return true;
+            }
+            FString String;
+            if (!ReadString(Ctx, String)) return false;
+            OutName = FName(*String);
+            Ctx.Names.Add(OutName);
+            return true;
+        }
+
+        void WriteType(FWriteContext& Ctx, const UScriptStruct* Type) {
+            uint32 Kind = TypeKindValue;
+            if (Type == nullptr || Type == FDaxFakeTypeEmpty::StaticStruct()) Kind = TypeKindEmpty;
+            else if (Type == FDaxFakeTypeArray::StaticStruct()) Kind = TypeKindArray;
+            else if (Type == FDaxFakeTypeMap::StaticStruct()) Kind = TypeKindMap;
+            Ctx.Writer->WriteBits(Kind, 2);
+            if (Kind != TypeKindValue) return;
+            if (const uint32* Index = Ctx.Types.Find(Type)) {
+                Ctx.Writer->WriteBool(true);
+                WritePackedUint32(Ctx.Writer, *Index);
+                return;
+            }
+            Ctx.Writer->WriteBool(false);
+            Ctx.Types.Add(Type, Ctx.Types.Num());
+            WriteString(Ctx.Writer, Type->GetPathName());
+        }
+
+        bool ReadType(FReadContext& Ctx, const UScriptStruct*& OutType) {
+            switch (Ctx.Reader->ReadBits(2)) {
+                case TypeKindEmpty: OutType = FDaxFakeTypeEmpty::StaticStruct(); return true;
+                case TypeKindArray: OutType = FDaxFakeTypeArray::StaticStruct(); return true;
+                case TypeKindMap: OutType = FDaxFakeTypeMap::StaticStruct(); return true;
+                default: break;
+            }
+            if (Ctx.Reader->ReadBool()) {
+                const uint32 Index = ReadPackedUint32(Ctx.Reader);
+                if (!Ctx.Types.IsValidIndex(static_cast<int32>(Index))) return Ctx.Fail();
+                OutType = Ctx.Types[Index];
+                return true;
+            }
+            FString Path;
+            if (!ReadString(Ctx, Path)) return false;
+            OutType = FindObject<UScriptStruct>(nullptr, *Path);
+            if (!OutType) OutType = LoadObject<UScriptStruct>(nullptr, *Path);
+            if (!OutType) {
+                UE_LOGFMT(DataXSystem, Error, "DaxSetNetSerializer: unknown value type {0}", Path);
+                return Ctx.Fail();
+            }
+            Ctx.Types.Add(OutType);
+            return true;
+        }
+
+        void WriteNodeID(FNetBitStreamWriter* Writer, const FDaxNodeID ID) {
+            Writer->WriteBits(ID.Index, 16);
+            Writer->WriteBits(ID.Generation, 16);
+        }
+
+        FDaxNodeID ReadNodeID(FNetBitStreamReader* Reader) {
+            const uint16 Index = static_cast<uint16>(Reader->ReadBits(16));
+            const uint16 Generation = static_cast<uint16>(Reader->ReadBits(16));
+            return FDaxNodeID(Index, Generation);
+        }
+
+        void WriteSlot(FWriteContext& Ctx, const FDaxIrisSlot& Slot) {
+            FNetBitStreamWriter* Writer = Ctx.Writer;
+            Writer->WriteBits(Slot.Generation, 16);
+            if (Writer->WriteBool(Slot.Parent.IsValid())) WriteNodeID(Writer, Slot.Parent);
+            WriteType(Ctx, Slot.Type);
+            if (Slot.Type == FDaxFakeTypeArray::StaticStruct()) {
+                WritePackedUint32(Writer, static_cast<uint32>(Slot.Children.Num()));
+                for (const FDaxNodeID Child : Slot.Children) WriteNodeID(Writer, Child);
+            }
+            else if (Slot.Type == FDaxFakeTypeMap::StaticStruct()) {
+                WritePackedUint32(Writer, static_cast<uint32>(Slot.Entries.Num()));
+                for (const TPair<FName, FDaxNodeID>& Entry : Slot.Entries) {
+                    WriteName(Ctx, Entry.Key);
+                    WriteNodeID(Writer, Entry.Value);
+                }
+            }
+            else if (Slot.Type && Slot.Type != FDaxFakeTypeEmpty::StaticStruct()) {
+                WritePackedUint32(Writer, Slot.PayloadBits);
+                WriteBytes(Writer, Slot.Payload.GetData(), Slot.PayloadBits);
+            }
+        }
+
+        bool ReadSlot(FReadContext& Ctx, FDaxIrisSlot& Slot) {
+            FNetBitStreamReader* Reader = Ctx.Reader;
+            Slot.Generation = static_cast<uint16>(Reader->ReadBits(16));
+            if (Reader->ReadBool()) Slot.Parent = ReadNodeID(Reader);
+            if (!ReadType(Ctx, Slot.Type)) return false;
+            if (Slot.Type == FDaxFakeTypeArray::StaticStruct()) {
+                const uint32 Count = ReadPackedUint32(Reader);
+                if (Count > ArzDax::FDaxAllocator::TotalCapacity) return Ctx.Fail();
+                Slot.Children.SetNumUninitialized(Count);
+                for (uint32 i = 0; i < Count; ++i) Slot.Children[i] = ReadNodeID(Reader);
+            }
+            else if (Slot.Type == FDaxFakeTypeMap::StaticStruct()) {
+                const uint32 Count = ReadPackedUint32(Reader);
+                if (Count > ArzDax::FDaxAllocator::TotalCapacity) return Ctx.Fail();
+                Slot.Entries.Reserve(Count);
+                for (uint32 i = 0; i < Count; ++i) {
+                    FName Key;
+                    if (!ReadName(Ctx, Key)) return false;
+                    Slot.Entries.Emplace(Key, ReadNodeID(Reader));
+                }
+            }
+            else if (Slot.Type != FDaxFakeTypeEmpty::StaticStruct()) {
+                Slot.PayloadBits = ReadPackedUint32(Reader);
+                if (Slot.PayloadBits > MaxPayloadBits) return Ctx.Fail();
+                Slot.Payload.SetNumZeroed((Slot.PayloadBits + 7) >> 3);
+                ReadBytes(Reader, Slot.Payload.GetData(), Slot.PayloadBits);
+            }
+            return !Reader->IsOverflown();
+        }
+
+        // Prev 为空时写全量; 否则只写与 Prev 指针不同的块/槽位
+        void WriteState(FNetBitStreamWriter* Writer, const FDaxIrisState* State, const FDaxIrisState* Prev) {
+            FWriteContext Ctx;
+            Ctx.Writer = Writer;
+            const int32 ChunkCount = State ? State->Chunks.Num() : 0;
+            WritePackedUint32(Writer, State ? State->PredictionWatermark : 0);
+            WritePackedUint32(Writer, static_cast<uint32>(ChunkCount));
+            for (int32 ci = 0; ci < ChunkCount; ++ci) {
+                const FDaxIrisChunk* Chunk = State->GetChunk(ci);
+                const FDaxIrisChunk* PrevChunk = Prev ? Prev->GetChunk(ci) : nullptr;
+                if (Prev && !Writer->WriteBool(Chunk != PrevChunk)) continue;
+                if (!Writer->WriteBool(Chunk != nullptr)) continue;
+                Writer->WriteBits(Chunk->UsedMask, 32);
+                uint32 Mask = Chunk->UsedMask;
+                while (Mask) {
+                    const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+                    Mask &= ~(1u << LocalIndex);
+                    const FDaxIrisSlot* Slot = Chunk->Slots[LocalIndex].Get();
+                    if (Prev && Writer->WriteBool(Slot == FDaxIrisState::GetSlot(PrevChunk, LocalIndex))) continue;
+                    WriteSlot(Ctx, *Slot);
+                }
+            }
+        }
+
+        // 未变化的块/槽位直接引用基线的指针, 客户端应用时同样按指针跳过
+        const FDaxIrisState* ReadState(FNetSerializationContext& Context, const FDaxIrisState* Prev) {
+            FReadContext Ctx;
+            Ctx.Context = &Context;
+            Ctx.Reader = Context.GetBitStreamReader();
+            const uint32 PredictionWatermark = ReadPackedUint32(Ctx.Reader);
+            const uint32 ChunkCount = ReadPackedUint32(Ctx.Reader);
+            if (ChunkCount > MaxChunks) {
+                Ctx.Fail();
+                return nullptr;
+            }
+
+            TRefCountPtr<FDaxIrisState> State = new FDaxIrisState();
+            State->PredictionWatermark = PredictionWatermark;
+            State->Chunks.SetNum(ChunkCount);
+            for (uint32 ci = 0; ci < ChunkCount; ++ci) {
+                const FDaxIrisChunk* PrevChunk = Prev ? Prev->GetChunk(ci) : nullptr;
+                if (Prev && !Ctx.Reader->ReadBool()) {
+                    if (PrevChunk) State->Chunks[ci] = Prev->Chunks[ci];
+                    continue;
+                }
+                if (!Ctx.Reader->ReadBool()) continue;
+                TSharedPtr<FDaxIrisChunk> Chunk = MakeShared<FDaxIrisChunk>();
+                Chunk->UsedMask = Ctx.Reader->ReadBits(32);
+                uint32 Mask = Chunk->UsedMask;
+                while (Mask) {
+                    const uint16 LocalIndex = static_cast<uint16>(FMath::CountTrailingZeros(Mask));
+                    Mask &= ~(1u << LocalIndex);
+                    if (Prev && Ctx.Reader->ReadBool()) {
+                        if (!FDaxIrisState::GetSlot(PrevChunk, LocalIndex)) {
+                            Ctx.Fail();
+                            return nullptr;
+                        }
+                        Chunk->Slots[LocalIndex] = PrevChunk->Slots[LocalIndex];
+                        continue;
+                    }
+                    TSharedPtr<FDaxIrisSlot> Slot = MakeShared<FDaxIrisSlot>();
+                    if (!ReadSlot(Ctx, *Slot)) return nullptr;
+                    Chunk->Slots[LocalIndex] = Slot;
+                }
+                State->Chunks[ci] = Chunk;
+            }
+            if (Ctx.Reader->IsOverflown()) return nullptr;
+            State->AddRef(); // 交给量化状态持有
+            return State.GetReference();
+        }
+
+        void Assign(FDaxSetNetSerializer::FQuantizedType& Target, const FDaxIrisState* State) {
+            if (State) State->AddRef();
+            if (Target.State) Target.State->Release();
+            Target.State = State;
+        }
+    }
+
+    void FDaxSetNetSerializer::Serialize(FNetSerializationContext& Context, const FNetSerializeArgs& Args) {
+        const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+        DaxIris::WriteState(Context.GetBitStreamWriter(), Source.State, nullptr);
+    }
+
+    void FDaxSetNetSerializer::Deserialize(FNetSerializationContext& Context, const FNetDeserializeArgs& Args) {
+        QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+        const ArzDax::FDaxIrisState* State = DaxIris::ReadState(Context, nullptr);
+        if (!State) return;
+        DaxIris::Assign(Target, State);
+        State->Release();
+    }
+
+    void FDaxSetNetSerializer::SerializeDelta(FNetSerializationContext& Context, const FNetSerializeDeltaArgs& Args) {
+        const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+        const QuantizedType& Prev = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+        DaxIris::WriteState(Context.GetBitStreamWriter(), Source.State, Prev.State);
+    }
+
+    void FDaxSetNetSerializer::DeserializeDelta(FNetSerializationContext& Context, const FNetDeserializeDeltaArgs& Args) {
+        QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+        const QuantizedType& Prev = *reinterpret_cast<const QuantizedType*>(Args.Prev);
+        const ArzDax::FDaxIrisState* State = DaxIris::ReadState(Context, Prev.State);
+        if (!State) return;
+        DaxIris::Assign(Target, State);
+        State->Release();
+    }
+
+    void FDaxSetNetSerializer::Quantize(FNetSerializationContext& Context, const FNetQuantizeArgs& Args) {
+        // 脏块的重新量化已经在 UDaxComponent 标脏时完成, 这里只接过引用
+        const SourceType& Source = *reinterpret_cast<const SourceType*>(Args.Source);
+        QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+        DaxIris::Assign(Target, Source.State.GetReference());
+    }
+
+    void FDaxSetNetSerializer::Dequantize(FNetSerializationContext& Context, const FNetDequantizeArgs& Args) {
+        const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+        SourceType& Target = *reinterpret_cast<SourceType*>(Args.Target);
+        Target.State = Source.State;
+    }
+
+    bool FDaxSetNetSerializer::IsEqual(FNetSerializationContext& Context, const FNetIsEqualArgs& Args) {
+        if (Args.bStateIsQuantized) {
+            return reinterpret_cast<const QuantizedType*>(Args.Source0)->State == reinterpret_cast<const QuantizedType*>(Args.Source1)->State;
+        }
+        return *reinterpret_cast<const SourceType*>(Args.Source0) == *reinterpret_cast<const SourceType*>(Args.Source1);
+    }
+
+    bool FDaxSetNetSerializer::Validate(FNetSerializationContext& Context, const FNetValidateArgs& Args) {
+        return true;
+    }
+
+    void FDaxSetNetSerializer::CloneDynamicState(FNetSerializationContext& Context, const FNetCloneDynamicStateArgs& Args) {
+        const QuantizedType& Source = *reinterpret_cast<const QuantizedType*>(Args.Source);
+        QuantizedType& Target = *reinterpret_cast<QuantizedType*>(Args.Target);
+        Target.State = Source.State; // 目标是源的逐字节拷贝, 只需补上引用
+        if (Target.State) Target.State->AddRef();
+    }
+
+    void FDaxSetNetSerializer::FreeDynamicState(FNetSerializationContext& Context, const FNetFreeDynamicStateArgs& Args) {
+        QuantizedType& Source = *reinterpret_cast<QuantizedType*>(Args.Source);
+        if (Source.State) Source.State->Release();
+        Source.State = nullptr;
+    }
+
+    static const FName PropertyNetSerializerRegistry_NAME_DaxIrisStateHandle("DaxIrisStateHandle");
+    UE_NET_IMPLEMENT_NAMED_STRUCT_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_DaxIrisStateHandle, FDaxSetNetSerializer);
+
+    class FDaxSetNetSerializerRegistryDelegates final : private FNetSerializerRegistryDelegates {
+    public:
+        virtual ~FDaxSetNetSerializerRegistryDelegates() override {
+            UE_NET_UNREGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_DaxIrisStateHandle);
+        }
+
+    private:
+        virtual void OnPreFreezeNetSerializerRegistry() override {
+            UE_NET_REGISTER_NETSERIALIZER_INFO(PropertyNetSerializerRegistry_NAME_DaxIrisStateHandle);
+        }
+    };
+
+    static FDaxSetNetSerializerRegistryDelegates DaxSetNetSerializerRegistryDelegates;
+}
+#endif
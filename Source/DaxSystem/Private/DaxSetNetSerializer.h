@@ -0,0 +1,45 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "DaxSystem/Private/DaxIrisState.h"
+#if UE_WITH_IRIS
+#include "Iris/Serialization/NetSerializer.h"
+#endif
+#include "Iris/Serialization/NetSerializerConfig.h"
+#include "DaxSetNetSerializer.generated.h"
+
+// Iris 复制用的状态句柄: 只持有量化状态的引用, 拷贝只是一次引用计数.
+// FDaxSet 的拷贝是深拷贝, 不适合交给 Iris 轮询, 由 UDaxComponent 把这个句柄注册为 Iris 下的复制属性
+USTRUCT()
+struct DAXSYSTEM_API FDaxIrisStateHandle {
+    GENERATED_BODY()
+
+    TRefCountPtr<const ArzDax::FDaxIrisState> State {};
+
+    bool operator==(const FDaxIrisStateHandle& Other) const { return State == Other.State; }
+
+    // 传统复制路径下句柄始终为空, 不发送任何内容, 容器仍由 FDaxSet::NetDeltaSerialize 同步
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+        bOutSuccess = true;
+        return true;
+    }
+};
+
+template <>
+struct TStructOpsTypeTraits<FDaxIrisStateHandle> : public TStructOpsTypeTraitsBase2<FDaxIrisStateHandle> {
+    enum {
+        WithNetSerializer = true,
+        WithIdenticalViaEquality = true,
+    };
+};
+
+USTRUCT()
+struct FDaxSetNetSerializerConfig : public FNetSerializerConfig {
+    GENERATED_BODY()
+};
+
+#if UE_WITH_IRIS
+namespace UE::Net {
+    UE_NET_DECLARE_SERIALIZER(FDaxSetNetSerializer, DAXSYSTEM_API);
+}
+#endif
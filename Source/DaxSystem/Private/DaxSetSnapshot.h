@@ -0,0 +1,117 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "DaxSystem/Private/DaxAllocator.h"
+#include "DaxSystem/Private/DaxMap.h"
+#include "StructUtils/InstancedStruct.h"
+
+namespace ArzDax {
+
+    // 单个块在某个 Epoch 下的只读快照.
+    // 块没有变化时, 新版本直接复用旧指针, 容器镜像也按槽位复用, 只有真正变化的容器才会被拷贝.
+    struct FDaxChunkSnapshot {
+        FDaxNodeChunkMeta Meta {};
+
+        uint32 Epoch = 0;
+
+        TSharedPtr<const TArray<FDaxNodeID>> Arrays[DAX_NODE_POOR_CHUNK_SIZE] {};
+
+        TSharedPtr<const FDaxMapType> Maps[DAX_NODE_POOR_CHUNK_SIZE] {};
+
+        TSharedPtr<const FInstancedStruct> Values[DAX_NODE_POOR_CHUNK_SIZE] {}; // 仅开启属性级增量的值类型才有影子
+    };
+
+    // 整个容器在某个 DataVersion 下的只读快照, 同一版本的所有连接共享同一份
+    struct FDaxSetSnapshot {
+        uint32 DataVersion = 0;
+
+        uint32 ChunkEpoch = 0;
+
+        TArray<TSharedPtr<const FDaxChunkSnapshot>> Chunks {};
+
+        FORCEINLINE int32 GetChunkCount() const { return Chunks.Num(); }
+
+        FORCEINLINE const FDaxChunkSnapshot* GetChunk(const int32 ChunkIndex) const {
+            return Chunks.IsValidIndex(ChunkIndex) ? Chunks[ChunkIndex].Get() : nullptr;
+        }
+
+        FORCEINLINE const FDaxNodeChunkMeta* GetChunkMeta(const int32 ChunkIndex) const {
+            const FDaxChunkSnapshot* Chunk = GetChunk(ChunkIndex);
+            return Chunk ? &Chunk->Meta : nullptr;
+        }
+
+        FORCEINLINE const TArray<FDaxNodeID>* FindArray(const FDaxNodeID ID) const {
+            uint16 LocalIndex = 0;
+            const FDaxChunkSnapshot* Chunk = FindSlot(ID, LocalIndex);
+            return Chunk ? Chunk->Arrays[LocalIndex].Get() : nullptr;
+        }
+
+        FORCEINLINE const FDaxMapType* FindMap(const FDaxNodeID ID) const {
+            uint16 LocalIndex = 0;
+            const FDaxChunkSnapshot* Chunk = FindSlot(ID, LocalIndex);
+            return Chunk ? Chunk->Maps[LocalIndex].Get() : nullptr;
+        }
+
+        FORCEINLINE const FInstancedStruct* FindValue(const FDaxNodeID ID) const {
+            uint16 LocalIndex = 0;
+            const FDaxChunkSnapshot* Chunk = FindSlot(ID, LocalIndex);
+            return Chunk ? Chunk->Values[LocalIndex].Get() : nullptr;
+        }
+
+        // 拷贝一份连接视角下的快照, 只复制涉及的块:
+        // RemovedIDs 的槽位视为不存在, EmptiedIDs 的槽位视为空节点(内容不可见)
+        TSharedPtr<const FDaxSetSnapshot> MakeMasked(TConstArrayView<FDaxNodeID> RemovedIDs, TConstArrayView<FDaxNodeID> EmptiedIDs, const UScriptStruct* EmptyType) const {
+            TSharedPtr<FDaxSetSnapshot> Copy = MakeShared<FDaxSetSnapshot>(*this);
+            TMap<int32, TSharedPtr<FDaxChunkSnapshot>> Touched;
+            auto MaskSlot = [&](const FDaxNodeID ID, const bool bRemove) {
+                const int32 ChunkIndex = ID.Index >> DAX_NODE_POOR_CHUNK_SHIFT;
+                if (!Chunks.IsValidIndex(ChunkIndex) || !Chunks[ChunkIndex].IsValid()) return;
+                TSharedPtr<FDaxChunkSnapshot>& Chunk = Touched.FindOrAdd(ChunkIndex);
+                if (!Chunk.IsValid()) {
+                    Chunk = MakeShared<FDaxChunkSnapshot>(*Chunks[ChunkIndex]);
+                    Copy->Chunks[ChunkIndex] = Chunk;
+                }
+                const uint16 LocalIndex = static_cast<uint16>(ID.Index & DAX_NODE_POOR_CHUNK_MASK);
+                if (bRemove) Chunk->Meta.UsedMask &= ~(DAX_NODE_POOR_BASE_NUMBER << LocalIndex);
+                else Chunk->Meta.ValueType[LocalIndex] = EmptyType;
+                Chunk->Arrays[LocalIndex].Reset();
+                Chunk->Maps[LocalIndex].Reset();
+                Chunk->Values[LocalIndex].Reset();
+            };
+            for (const FDaxNodeID ID : RemovedIDs) MaskSlot(ID, true);
+            for (const FDaxNodeID ID : EmptiedIDs) MaskSlot(ID, false);
+            return Copy;
+        }
+
+        // 拷贝一份快照, StaleIDs 的槽位退回 Old 中的版本与值影子, 延后发送的更新下次仍会被比较出来
+        TSharedPtr<const FDaxSetSnapshot> MakeStale(TConstArrayView<FDaxNodeID> StaleIDs, const FDaxSetSnapshot& Old) const {
+            TSharedPtr<FDaxSetSnapshot> Copy = MakeShared<FDaxSetSnapshot>(*this);
+            TMap<int32, TSharedPtr<FDaxChunkSnapshot>> Touched;
+            for (const FDaxNodeID ID : StaleIDs) {
+                uint16 LocalIndex = 0;
+                const FDaxChunkSnapshot* OldChunk = Old.FindSlot(ID, LocalIndex);
+                const int32 ChunkIndex = ID.Index >> DAX_NODE_POOR_CHUNK_SHIFT;
+                if (!OldChunk || !Chunks.IsValidIndex(ChunkIndex) || !Chunks[ChunkIndex].IsValid()) continue;
+                TSharedPtr<FDaxChunkSnapshot>& Chunk = Touched.FindOrAdd(ChunkIndex);
+                if (!Chunk.IsValid()) {
+                    Chunk = MakeShared<FDaxChunkSnapshot>(*Chunks[ChunkIndex]);
+                    Copy->Chunks[ChunkIndex] = Chunk;
+                }
+                Chunk->Meta.Versions[LocalIndex] = OldChunk->Meta.Versions[LocalIndex];
+                Chunk->Values[LocalIndex] = OldChunk->Values[LocalIndex];
+            }
+            return Copy;
+        }
+
+    private:
+        FORCEINLINE const FDaxChunkSnapshot* FindSlot(const FDaxNodeID ID, uint16& OutLocalIndex) const {
+            if (!ID.IsValid()) return nullptr;
+            const FDaxChunkSnapshot* Chunk = GetChunk(ID.Index >> DAX_NODE_POOR_CHUNK_SHIFT);
+            if (!Chunk) return nullptr;
+            OutLocalIndex = static_cast<uint16>(ID.Index & DAX_NODE_POOR_CHUNK_MASK);
+            if ((Chunk->Meta.UsedMask & (DAX_NODE_POOR_BASE_NUMBER << OutLocalIndex)) == 0) return nullptr;
+            if (Chunk->Meta.Generations[OutLocalIndex] != ID.Generation) return nullptr;
+            return Chunk;
+        }
+    };
+}
@@ -1,5 +1,13 @@
 ﻿#include "DaxSystem/Public/DaxSubsystem.h"
 #include "Net/Core/PushModel/PushModel.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarDaxEventParallelCollectMin(
+    TEXT("dax.Event.ParallelCollectMin"),
+    64,
+    TEXT("Minimum number of components with pending changes before listener collection runs on worker threads; 0 always collects on the game thread."),
+    ECVF_Default);
 
 bool UDaxSubsystem::ShouldCreateSubsystem(UObject* Outer) const {
     if (!IsValid(Outer)) return false;
@@ -32,7 +40,6 @@ void UDaxSubsystem::HandleWorldPreActorTick(UWorld* InWorld, ELevelTick TickType
 }
 
 void UDaxSubsystem::EarlyTick(float DeltaSeconds) {
-    // 当前阶段仅做批量 Push 和帧变更集合清理，监听事件尚未实现
     CollectEvent();
     DispatchEvent();
 }
@@ -50,18 +57,49 @@ void UDaxSubsystem::UnregisterComponent(UDaxComponent* Component) {
 }
 
 void UDaxSubsystem::CollectEvent() {
-    // 预留：后续在此做多线程筛选/聚合（监听系统未启用）
+    // 预测结算回调在游戏线程执行, 先结算超时的预测(回滚也算变更)
+    const double Now = FPlatformTime::Seconds();
+    CollectingComponents.Reset();
+    // 结算回调可能生成或销毁组件并改动组件表, 遍历一份快照, 每个组件处理前重新检查
+    const TArray<UDaxComponent*> Components = DaxComponentTable;
+    for (UDaxComponent* Comp : Components) {
+        if (!IsValid(Comp) || Comp->IsBeingDestroyed()) continue;
+        Comp->DataSet.FlushPredictions(Now);
+        if (Comp->DataSet.HasOnChangedWork()) CollectingComponents.Add(Comp);
+        else Comp->DataSet.ClearFrameChangedNodes();
+    }
+    if (CollectingComponents.IsEmpty()) return;
+
+    // 每个组件只匹配自己的变更与监听, 结果写入各自的派发列表; 委托调用留在 DispatchEvent
+    const int32 MinParallel = CVarDaxEventParallelCollectMin.GetValueOnGameThread();
+    const bool bParallel = MinParallel > 0 && CollectingComponents.Num() >= MinParallel;
+    ParallelFor(CollectingComponents.Num(), [this](const int32 Index) {
+        CollectingComponents[Index]->DataSet.CollectOnChanged();
+    }, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+    CollectingComponents.Reset();
 }
 
 void UDaxSubsystem::DispatchEvent() {
-    // 批量 Flush PushModel + 清理本帧变更集合
-    DaxComponentTable.RemoveAll([](UDaxComponent* Comp) {
-        if (!IsValid(Comp) || Comp->IsBeingDestroyed()) return true;
-        if (Comp->bPendingDirty) {
+    // 批量 Flush PushModel + 派发监听 + 发送客户端预测 + 释放本帧旧值; 本帧变更集合已在收集时取走
+    // 先剔除失效组件(这一步不调用任何外部代码), 再遍历快照: 回调中生成或销毁组件会改动组件表
+    DaxComponentTable.RemoveAll([](const UDaxComponent* Comp) { return !IsValid(Comp) || Comp->IsBeingDestroyed(); });
+    CollectingComponents = DaxComponentTable;
+    for (UDaxComponent* Comp : CollectingComponents) {
+        if (!IsValid(Comp) || Comp->IsBeingDestroyed()) continue;
+        if (Comp->bPendingDirty || Comp->DataSet.ConsumeNetHydrationPending()) {
             MARK_PROPERTY_DIRTY_FROM_NAME(UDaxComponent, DataSet, Comp);
+            Comp->UpdateIrisState();
             Comp->bPendingDirty = false;
         }
-        Comp->DataSet.ClearFrameChangedNodes();
-        return false;
-    });
+        if (Comp->DataSet.ConsumeHydratedEvent()) {
+            Comp->DataSet.OnHydrated.Broadcast();
+            Comp->OnHydrated.Broadcast();
+        }
+        if (!IsValid(Comp) || Comp->IsBeingDestroyed()) continue;
+        Comp->DataSet.DispatchOnChanged();
+        if (!IsValid(Comp) || Comp->IsBeingDestroyed()) continue;
+        Comp->FlushClientWrites();
+        Comp->DataSet.ReleaseFrameOldValues();
+    }
+    CollectingComponents.Reset();
 }
\ No newline at end of file
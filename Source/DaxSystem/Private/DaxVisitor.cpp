@@ -390,6 +390,8 @@ DAX_BUILTIN_TYPE_DEFINE(FName, const FName& Value, Name, FDaxBuiltinName)
 DAX_BUILTIN_TYPE_DEFINE(FString, const FString& Value, String, FDaxBuiltinString)
 DAX_BUILTIN_TYPE_DEFINE(FVector, const FVector& Value, Vector, FDaxBuiltinVector)
 DAX_BUILTIN_TYPE_DEFINE(FRotator, const FRotator& Value, Rotator, FDaxBuiltinRotator)
+DAX_BUILTIN_TYPE_DEFINE(FVector, const FVector& Value, VectorQ, FDaxBuiltinVectorQ)
+DAX_BUILTIN_TYPE_DEFINE(FRotator, const FRotator& Value, RotatorQ, FDaxBuiltinRotatorQ)
 
 // ================= Array 操作 =================
 FDaxVisitor FDaxVisitor::ArrayAdd() const {
@@ -414,8 +416,8 @@ FDaxVisitor FDaxVisitor::ArrayAdd() const {
     // 维护反向映射：数组下标
     TargetSet->Allocator.UpdateParentEdgeArray(ChildID, (uint16)(Arr->Num() - 1));
 
-    TargetSet->BumpNodeDataVersionAndStruct(Base.CachedNodeID);
-    TargetSet->BumpNodeDataVersionAndStruct(ChildID);
+    TargetSet->BumpNodeDataVersionAndStruct(Base.CachedNodeID, ArzDax::EDaxChangeOp::ArraySplice);
+    TargetSet->BumpNodeDataVersionAndStruct(ChildID, ArzDax::EDaxChangeOp::AddNode);
 
     // 返回新增元素的访问器
     FDaxVisitor ChildVisitor{};
@@ -468,9 +470,9 @@ FDaxResultDetail FDaxVisitor::ArrayEnsureMinNum(int32 Count) const {
         }
         // 新增子：设置反向映射（数组下标）
         TargetSet->Allocator.UpdateParentEdgeArray(ChildID, (uint16)(Curr + i));
-        TargetSet->BumpNodeDataVersionAndStruct(ChildID);
+        TargetSet->BumpNodeDataVersionAndStruct(ChildID, ArzDax::EDaxChangeOp::AddNode);
     }
-    TargetSet->BumpNodeDataVersionAndStruct(CachedNodeID);
+    TargetSet->BumpNodeDataVersionAndStruct(CachedNodeID, ArzDax::EDaxChangeOp::ArraySplice);
     return EDaxResult::SuccessChangeValue;
 }
 
@@ -492,7 +494,7 @@ bool FDaxVisitor::ArrayRemove() const {
     if (ChildID.IsValid()) {
         TargetSet->ReleaseRecursive(ChildID);
     }
-    TargetSet->BumpNodeDataVersionAndStruct(CachedNodeID);
+    TargetSet->BumpNodeDataVersionAndStruct(CachedNodeID, ArzDax::EDaxChangeOp::ArraySplice);
 
     return true;
 }
@@ -532,8 +534,8 @@ FDaxVisitor FDaxVisitor::ArrayInsert(int32 Index) const {
         if (Sid.IsValid()) TargetSet->Allocator.UpdateParentEdgeArray(Sid, (uint16)i);
     }
 
-    TargetSet->BumpNodeDataVersionAndStruct(Base.CachedNodeID);
-    TargetSet->BumpNodeDataVersionAndStruct(ChildID);
+    TargetSet->BumpNodeDataVersionAndStruct(Base.CachedNodeID, ArzDax::EDaxChangeOp::ArraySplice);
+    TargetSet->BumpNodeDataVersionAndStruct(ChildID, ArzDax::EDaxChangeOp::AddNode);
 
     // 返回插入位置的新元素访问器
     FDaxVisitor ChildVisitor{};
@@ -694,8 +696,8 @@ FDaxVisitor FDaxVisitor::MapAdd(FName Key) const {
         }
         // 维护反向映射：Map 的键
         TargetSet->Allocator.UpdateParentEdgeMap(ChildID, Key);
-        TargetSet->BumpNodeDataVersionAndStruct(Base.CachedNodeID);
-        TargetSet->BumpNodeDataVersionAndStruct(ChildID);
+        TargetSet->BumpNodeDataVersionAndStruct(Base.CachedNodeID, ArzDax::EDaxChangeOp::MapPut);
+        TargetSet->BumpNodeDataVersionAndStruct(ChildID, ArzDax::EDaxChangeOp::AddNode);
     }
 
     FDaxVisitor ChildVisitor{};
@@ -722,7 +724,7 @@ bool FDaxVisitor::MapRemove(FName Key) const {
         const FDaxNodeID ChildID = It->second;
         Map->erase(It);
         if (ChildID.IsValid()) TargetSet->ReleaseRecursive(ChildID);
-        TargetSet->BumpNodeDataVersionAndStruct(CachedNodeID);
+        TargetSet->BumpNodeDataVersionAndStruct(CachedNodeID, ArzDax::EDaxChangeOp::MapErase);
     }
 
     return true;
@@ -1015,7 +1017,7 @@ FDaxResultDetail FDaxVisitor::ResolvePathInternal(EDaxPathResolveMode Mode) cons
         if (auto InfoRef = TargetSet->Allocator.GetCommonInfoRef(CurrentID); InfoRef.IsValid() && InfoRef.pParent) {
             *InfoRef.pParent = FDaxNodeID();
         }
-        TargetSet->BumpNodeDataVersionAndStruct(CurrentID);
+        TargetSet->BumpNodeDataVersionAndStruct(CurrentID, ArzDax::EDaxChangeOp::AddNode);
     }
 
     ArzDax::FDaxNode* CurrentNode = TargetSet->TryGetNode(CurrentID);
@@ -1117,8 +1119,8 @@ FDaxResultDetail FDaxVisitor::ResolvePathInternal(EDaxPathResolveMode Mode) cons
 
                 (*Map)[*Key] = ChildID;
 
-                TargetSet->BumpNodeDataVersionAndStruct(CurrentID);
-                TargetSet->BumpNodeDataVersionAndStruct(ChildID);
+                TargetSet->BumpNodeDataVersionAndStruct(CurrentID, ArzDax::EDaxChangeOp::MapPut);
+                TargetSet->BumpNodeDataVersionAndStruct(ChildID, ArzDax::EDaxChangeOp::AddNode);
 
                 CurrentID = ChildID;
                 CurrentNode = TargetSet->TryGetNode(CurrentID);
@@ -1231,8 +1233,8 @@ FDaxResultDetail FDaxVisitor::ResolvePathInternal(EDaxPathResolveMode Mode) cons
                 }
                 if (InfoRef.pParent) *InfoRef.pParent = CurrentID;
 
-                TargetSet->BumpNodeDataVersionAndStruct(CurrentID);
-                TargetSet->BumpNodeDataVersionAndStruct(ChildID);
+                TargetSet->BumpNodeDataVersionAndStruct(CurrentID, ArzDax::EDaxChangeOp::ArraySplice);
+                TargetSet->BumpNodeDataVersionAndStruct(ChildID, ArzDax::EDaxChangeOp::AddNode);
 
                 CurrentID = ChildID;
                 CurrentNode = TargetSet->TryGetNode(CurrentID);
@@ -0,0 +1,72 @@
+﻿#include "DaxSystem/Private/DaxWriteBatch.h"
+#include "DaxSystem/Private/DaxCommon.h"
+#include "DaxSystem/Private/DaxNetDictionary.h"
+#include "UObject/CoreNet.h"
+
+using namespace ArzDax;
+
+namespace {
+    bool IsContainerOrEmptyType(const UScriptStruct* Type) {
+        return Type == nullptr || Type == FDaxFakeTypeEmpty::StaticStruct() || Type == FDaxFakeTypeArray::StaticStruct() || Type == FDaxFakeTypeMap::StaticStruct();
+    }
+
+    void SerializeValue(FArchive& Ar, UPackageMap* Map, const UScriptStruct* Type, void* Memory) {
+        if (Type->GetCppStructOps()->HasNetSerializer()) {
+            bool Success = true;
+            Type->GetCppStructOps()->NetSerialize(Ar, Map, Success, Memory);
+            if (!Success) Ar.SetError();
+        }
+        else {
+            Type->SerializeBin(Ar, Memory);
+        }
+    }
+}
+
+bool FDaxWriteBatch::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess) {
+    bOutSuccess = false;
+    uint32 Count = static_cast<uint32>(FMath::Min(Entries.Num(), static_cast<int32>(MaxEntries)));
+    Ar.SerializeIntPacked(Count);
+    if (Count > MaxEntries) { // 来自客户端的数据, 超出上限直接丢弃整批
+        Ar.SetError();
+        return true;
+    }
+
+    // 类型字典只在本批内有效, 同一类型第二次出现时只发下标
+    FDaxNetTypeWriter TypeWriter(nullptr, FDaxNetTypeCodec::MaxUserTypes);
+    FDaxNetTypeReader TypeReader;
+    FDaxNodeIDListCodec IDs;
+    if (Ar.IsLoading()) Entries.SetNum(Count);
+
+    for (uint32 i = 0; i < Count; ++i) {
+        FDaxWriteBatchEntry& Entry = Entries[i];
+        if (Ar.IsSaving()) IDs.Write(Ar, Entry.ID);
+        else IDs.Read(Ar, Entry.ID);
+        Ar.SerializeIntPacked(Entry.PredictionKey);
+
+        uint8 bHasValue = Entry.Value.IsValid() ? 1 : 0;
+        Ar.SerializeBits(&bHasValue, 1);
+        if (!bHasValue) {
+            if (Ar.IsLoading()) Entry.Value.Reset();
+            continue;
+        }
+
+        if (Ar.IsSaving()) {
+            FDaxNetTypeCodec::Write(Ar, Map, Entry.Value.GetScriptStruct(), TypeWriter);
+            SerializeValue(Ar, Map, Entry.Value.GetScriptStruct(), Entry.Value.GetMutableMemory());
+            continue;
+        }
+
+        const UScriptStruct* Type = nullptr;
+        if (!FDaxNetTypeCodec::Read(Ar, Map, TypeReader, Type) || IsContainerOrEmptyType(Type)) {
+            UE_LOGFMT(DataXSystem, Warning, "DaxWriteBatch: entry {0} has an unresolved or non-value type, dropping the batch", Entry.ID.ToString());
+            Ar.SetError();
+            return true;
+        }
+        Entry.Value.InitializeAs(Type);
+        SerializeValue(Ar, Map, Type, Entry.Value.GetMutableMemory());
+        if (Ar.IsError()) return true;
+    }
+
+    bOutSuccess = !Ar.IsError();
+    return true;
+}
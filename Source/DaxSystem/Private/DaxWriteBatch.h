@@ -0,0 +1,35 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "DaxSystem/Private/DaxNodeID.h"
+#include "StructUtils/InstancedStruct.h"
+#include "DaxWriteBatch.generated.h"
+
+struct FDaxWriteBatchEntry {
+    FDaxNodeID ID {};
+
+    uint32 PredictionKey = 0;
+
+    FInstancedStruct Value {}; // 无效表示把节点清空为空节点
+};
+
+// 客户端一帧内的全部预测写入, 作为一次 Server RPC 发送.
+// 按节点 ID 寻址(客户端的 ID 与服务端一致, 代数不符即视为过期); 线上格式:
+// 条目数 -> 每条: ID(间隔编码) + 预测键 + 1bit 有值 -> 有值: 类型(批内字典) + 值
+USTRUCT()
+struct DAXSYSTEM_API FDaxWriteBatch {
+    GENERATED_BODY()
+
+    static constexpr uint32 MaxEntries = 256;
+
+    TArray<FDaxWriteBatchEntry> Entries {};
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FDaxWriteBatch> : public TStructOpsTypeTraitsBase2<FDaxWriteBatch> {
+    enum {
+        WithNetSerializer = true,
+    };
+};
@@ -41,6 +41,14 @@ struct DAXSYSTEM_API FDaxBuiltinFloat {
 
     UPROPERTY()
     float Value = 0;
+
+    // 无损: 能精确表示为 int32 的值(计数, 整数倍率等)走 ZigZag 变长, 其余写原始 32bit
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FDaxBuiltinFloat> : public TStructOpsTypeTraitsBase2<FDaxBuiltinFloat> {
+    enum { WithNetSerializer = true };
 };
 
 USTRUCT()
@@ -75,3 +83,45 @@ struct DAXSYSTEM_API FDaxBuiltinRotator {
     FRotator Value{};
 };
 
+// 量化精度, 与引擎的 FVector_NetQuantize / NetQuantize10 / NetQuantize100 一致
+UENUM()
+enum class EDaxVectorQuantization : uint8 {
+    Unit,       // 1 单位精度, 每分量最多 20bit
+    Decimeter,  // 0.1 单位精度, 每分量最多 24bit
+    Centimeter, // 0.01 单位精度, 每分量最多 30bit
+};
+
+// 有损的网络量化向量: 适合位置一类的数据, 超出量化范围的分量会被截断
+USTRUCT()
+struct DAXSYSTEM_API FDaxBuiltinVectorQ {
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FVector Value{};
+
+    UPROPERTY()
+    EDaxVectorQuantization Quantization = EDaxVectorQuantization::Decimeter;
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FDaxBuiltinVectorQ> : public TStructOpsTypeTraitsBase2<FDaxBuiltinVectorQ> {
+    enum { WithNetSerializer = true };
+};
+
+// 有损的网络量化旋转: 每个分量压缩为 16bit, 为 0 的分量只占 1bit
+USTRUCT()
+struct DAXSYSTEM_API FDaxBuiltinRotatorQ {
+    GENERATED_BODY()
+
+    UPROPERTY()
+    FRotator Value{};
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template <>
+struct TStructOpsTypeTraits<FDaxBuiltinRotatorQ> : public TStructOpsTypeTraitsBase2<FDaxBuiltinRotatorQ> {
+    enum { WithNetSerializer = true };
+};
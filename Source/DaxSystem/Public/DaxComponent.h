@@ -2,9 +2,24 @@
 
 #include "CoreMinimal.h"
 #include "DaxSystem/Private/DaxSet.h"
+#include "DaxSystem/Private/DaxSetNetSerializer.h"
+#include "DaxSystem/Private/DaxWriteBatch.h"
 #include "Components/ActorComponent.h"
 #include "DaxComponent.generated.h"
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FDaxOnHydratedDynamic);
+
+// 客户端预测写入发往服务端的方式
+UENUM(BlueprintType)
+enum class EDaxWriteDelivery : uint8 {
+    Disabled,   // 只保留在本地 Overlay
+    Unreliable, // 每帧一批, 丢失后由预测超时兜底
+    Reliable,
+};
+
+// 服务端写入权限检查: NewValue 无效表示清空为空节点; 返回 true 才会写入
+DECLARE_DELEGATE_RetVal_ThreeParams(bool, FDaxWriteAuthority, UDaxComponent* /*Component*/, const FDaxVisitor& /*Position*/, FConstStructView /*NewValue*/);
+
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
 class DAXSYSTEM_API UDaxComponent : public UActorComponent {
     GENERATED_BODY()
@@ -19,11 +34,17 @@ public:
     UPROPERTY(Replicated)
     FDaxSet DataSet {};
 
+    // Iris 复制路径: 服务端量化后的容器状态, 与 DataSet 二选一激活
+    UPROPERTY(ReplicatedUsing=OnRep_IrisState)
+    FDaxIrisStateHandle IrisState {};
+
     virtual void GetLifetimeReplicatedProps(TArray<class FLifetimeProperty>& OutLifetimeProps) const override;
 
     // 调整注册时机：在 OnRegister/OnUnregister 与 Subsystem 交互
     virtual void OnRegister() override;
     virtual void OnUnregister() override;
+
+    virtual void PreReplication(IRepChangedPropertyTracker& ChangedPropertyTracker) override;
     
     UFUNCTION(BlueprintCallable)
     FDaxVisitor GetVisitor() const { return DataSet.GetVisitor(); }
@@ -40,8 +61,14 @@ public:
     UFUNCTION(BlueprintCallable)
     int GetNodeNum() const { return DataSet.GetNodeNum(); }
 
+    // bCaptureOldValues: 开启后子树内的值节点在同步覆盖前保存旧值, 回调中可用 TryGetOld* 读取
+    // 回调经 ProcessEvent 调用, 每次派发都会构造访问器和参数帧; C++ 监听请用 DataSet 的 BindOnChangedNative
+    UFUNCTION(BlueprintCallable)
+    bool BindOnChanged(const FDaxVisitor& Position, const int32 Depth, UObject* Target, const FName& FuncName, const bool bCaptureOldValues = false);
+
+    // 聚合监听: 函数签名 (const FDaxVisitor& ListenPosition, const TArray<FDaxChangeRecord>& Changes), 每帧最多一次
     UFUNCTION(BlueprintCallable)
-    bool BindOnChanged(const FDaxVisitor& Position, const int32 Depth, UObject* Target, const FName& FuncName);
+    bool BindOnChangedAggregate(const FDaxVisitor& Position, const int32 Depth, UObject* Target, const FName& FuncName, const bool bCaptureOldValues = false);
     
     UFUNCTION(BlueprintCallable)
     void UnbindOnChanged(const FDaxVisitor& Position);
@@ -51,4 +78,59 @@ public:
 
     UFUNCTION(BlueprintCallable)
     void MarkDirty();
+
+    // 客户端: 分帧全量同步尚未完成时为 true
+    UFUNCTION(BlueprintCallable)
+    bool IsHydrating() const { return DataSet.IsHydrating(); }
+
+    // 服务端: 设置子树的同步优先级, 新增节点分帧发送时优先级高的先发
+    UFUNCTION(BlueprintCallable)
+    bool SetNetPriority(const FDaxVisitor& Position, const int32 Priority) { return DataSet.SetNetPriority(Position, Priority); }
+
+    // 服务端: 设置子树的最小重发间隔(秒), 间隔内的值更新合并后再发送
+    UFUNCTION(BlueprintCallable)
+    bool SetNetUpdateInterval(const FDaxVisitor& Position, const float IntervalSeconds) { return DataSet.SetNetUpdateInterval(Position, IntervalSeconds); }
+
+    // 服务端: 设置子树的同步条件(拥有者可见/拥有者不可见), 自定义谓词请使用 FDaxSet::SetNetCondition
+    UFUNCTION(BlueprintCallable)
+    bool SetNetCondition(const FDaxVisitor& Position, const EDaxNetCondition Condition) { return Condition != EDaxNetCondition::Custom && DataSet.SetNetCondition(Position, Condition); }
+
+    // 客户端: 全量同步(含分帧水合)完成
+    UPROPERTY(BlueprintAssignable)
+    FDaxOnHydratedDynamic OnHydrated;
+
+    // 客户端: 本地预测写入是否打包发往服务端, 需要拥有者连接(Server RPC 的要求)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    EDaxWriteDelivery WriteDelivery = EDaxWriteDelivery::Disabled;
+
+    // 服务端: 客户端写入的权限检查, 未绑定时拒绝所有写入
+    FDaxWriteAuthority WriteAuthority {};
+
+    // 客户端: 由 Subsystem 每帧调用, 把本帧的预测写入合并为一次 RPC
+    void FlushClientWrites();
+
+    // 服务端: 由 Subsystem 在标脏时调用, 使用 Iris 复制时重新量化容器状态
+    void UpdateIrisState();
+
+    bool IsUsingIrisReplication() const;
+
+private:
+    UFUNCTION()
+    void OnRep_IrisState();
+
+    bool bReplicationPathChosen = false; // PreReplication 中已按 NetDriver 激活了其中一条复制路径
+
+    bool bIrisPathActive = false;
+
+    UFUNCTION(Server, Reliable)
+    void ServerApplyWrites(const FDaxWriteBatch& Batch);
+
+    UFUNCTION(Server, Unreliable)
+    void ServerApplyWritesUnreliable(const FDaxWriteBatch& Batch);
+
+    // 被拒绝的写入立即回滚; 值未变化的写入不会触发同步, 也在这里确认
+    UFUNCTION(Client, Unreliable)
+    void ClientAckWrites(const TArray<uint32>& RejectedKeys, const TArray<uint32>& UnchangedKeys);
+
+    void ApplyClientWrites(const FDaxWriteBatch& Batch);
 };
@@ -31,4 +31,6 @@ private:
     FDelegateHandle PreActorTickHandle;
 
     TArray<UDaxComponent*> DaxComponentTable{};
+
+    TArray<UDaxComponent*> CollectingComponents{}; // CollectEvent 的收集列表与 DispatchEvent 的组件表快照, 复用内存
 };
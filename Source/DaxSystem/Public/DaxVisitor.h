@@ -154,6 +154,8 @@ public:
     DAX_BUILTIN_TYPE_DECLARE(FString, const FString& Value, String)
     DAX_BUILTIN_TYPE_DECLARE(FVector, const FVector& Value, Vector)
     DAX_BUILTIN_TYPE_DECLARE(FRotator, const FRotator& Value, Rotator)
+    DAX_BUILTIN_TYPE_DECLARE(FVector, const FVector& Value, VectorQ)   // 网络量化(0.1 精度), 适合位置
+    DAX_BUILTIN_TYPE_DECLARE(FRotator, const FRotator& Value, RotatorQ) // 网络量化(16bit 分量)
 
 
     //Old Value